@@ -20,6 +20,10 @@
 #include <stdbool.h>
 #include "tm4c123gh6pm.h"
 #include "adc0.h"
+#include "clock.h"
+#include "timer1.h"
+#include "udma.h"
+#include "adcseq.h"
 
 #define ADC_CTL_DITHER          0x00000040
 
@@ -27,6 +31,13 @@
 // Global variables
 //-----------------------------------------------------------------------------
 
+// Ping-pong sample blocks filled by uDMA
+int16_t *adc0DmaBlock[2];
+
+// Loss events per sequencer (checks that found the OSTAT/USTAT bit set)
+uint32_t adc0Overflows[4];
+uint32_t adc0Underflows[4];
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
@@ -43,11 +54,59 @@ void initAdc0Ss1()
     ADC0_CC_R = ADC_CC_CS_SYSPLL;                    // select PLL as the time base (not needed, since default value)
     ADC0_PC_R = ADC_PC_SR_1M;                        // select 1Msps rate
     ADC0_EMUX_R = ADC_EMUX_EM1_PROCESSOR;            // select SS1 bit in ADCPSSI as trigger
-    ADC0_SSCTL1_R = ADC_SSCTL1_END2;                 // mark third sample as the end
-    //turn on interrupt bit?
-    ADC0_IM_R = ADC_IM_MASK1;
-    ADC0_SSCTL1_R = ADC_SSCTL1_IE2;
+    ADC0_SSMUX1_R = 0;                               // single step on AIN0 until a sequence is set
+    ADC0_SSCTL1_R = encodeAdcSsCtl(1, 0);
+    ADC0_IM_R = ADC_IM_MASK1;                        // send SS1 interrupt to the NVIC
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Initialize Hardware with SS1 started by Timer 1A at a fixed rate
+// rateHz is the sequence rate (one conversion of all three mics per trigger)
+void initAdc0Ss1Timed(uint32_t rateHz)
+{
+    initAdc0Ss1();
+
+    initTimer1();
+    setTimer1Rate(rateHz, SYSTEM_CLOCK_HZ);
+    enableTimer1AdcTrigger();
+
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC0_EMUX_R = (ADC0_EMUX_R & ~ADC_EMUX_EM1_M) | ADC_EMUX_EM1_TIMER;
+                                                     // select timer as SS1 trigger
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+
+    startTimer1();
+}
+
+// Change the Timer 1A sequence rate set by initAdc0Ss1Timed()
+void setAdc0Ss1Rate(uint32_t rateHz)
+{
+    setTimer1Rate(rateHz, SYSTEM_CLOCK_HZ);
+}
+
+// Return the actual SS1 sequence rate when triggered by Timer 1A
+uint32_t getAdc0Ss1Rate()
+{
+    return getTimer1Rate(SYSTEM_CLOCK_HZ);
+}
+
+// Set the converter rate (125000, 250000, 500000 or 1000000 samples/s)
+// Returns false and leaves the rate unchanged for any other value
+bool setAdc0ConversionRate(uint32_t sps)
+{
+    uint32_t pc;
+    switch (sps)
+    {
+        case 125000:  pc = ADC_PC_SR_125K; break;
+        case 250000:  pc = ADC_PC_SR_250K; break;
+        case 500000:  pc = ADC_PC_SR_500K; break;
+        case 1000000: pc = ADC_PC_SR_1M;   break;
+        default:      return false;
+    }
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC0_PC_R = pc;
     ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+    return true;
 }
 
 // Set SS1 input sample average count
@@ -62,14 +121,41 @@ void setAdc0Ss1Log2AverageCount(uint8_t log2AverageCount)
     ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
 }
 
-// Set SS1 analog input
-// we're using AIN1, AIN2, AIN4
-void setAdc0Ss1Mux()
+// Set the analog inputs of sequencer ss (0-2) from a list of count AIN
+// numbers in step order; repeats are allowed for oversampling
+// The last step ends the sequence and raises the interrupt/uDMA request
+// Returns false if the list does not fit the sequencer's FIFO depth
+bool setAdc0Sequence(uint8_t ss, const uint8_t ain[], uint8_t count)
 {
-    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
-    ADC0_SSMUX1_R = 0x1 ;
-    ADC0_SSMUX1_R |= 0x20 | 0x400;                           // Set analog input for 3 samples
-    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+    volatile uint32_t* p = &ADC0_SSMUX0_R;           // SSMUXn/SSCTLn repeat every 8 words
+    if (ss > 2 || count == 0 || count > getAdcSequencerDepth(ss))
+        return false;
+
+    ADC0_ACTSS_R &= ~(ADC_ACTSS_ASEN0 << ss);        // disable sample sequencer for programming
+    p[ss * 8] = encodeAdcSsMux(ain, count);
+    p[ss * 8 + 1] = encodeAdcSsCtl(count, 0);
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN0 << ss;           // enable sample sequencer for operation
+    return true;
+}
+
+// Set SS1 analog inputs from a list of count AIN numbers (1 to 4 steps)
+bool setAdc0Ss1Sequence(const uint8_t ain[], uint8_t count)
+{
+    return setAdc0Sequence(1, ain, count);
+}
+
+// Time between SS1 steps in ns (conversion period times the HW average count)
+uint32_t getAdc0Ss1StepNs()
+{
+    uint32_t ns;
+    switch (ADC0_PC_R & ADC_PC_SR_M)
+    {
+        case ADC_PC_SR_125K: ns = 8000; break;
+        case ADC_PC_SR_250K: ns = 4000; break;
+        case ADC_PC_SR_500K: ns = 2000; break;
+        default:             ns = 1000; break;
+    }
+    return ns << ADC0_SAC_R;
 }
 
 // Request and read one sample from SS1
@@ -80,3 +166,162 @@ int16_t readAdc0Ss1()
     while (ADC0_SSFSTAT1_R & ADC_SSFSTAT1_EMPTY);
     return ADC0_SSFIFO1_R;                           // get single result from the FIFO
 }
+
+// Number of results waiting in the SS1 FIFO (0 to 4)
+uint8_t getAdc0Ss1FifoCount()
+{
+    uint32_t stat = ADC0_SSFSTAT1_R;
+    if (stat & ADC_SSFSTAT1_FULL)
+        return 4;
+    return (((stat & ADC_SSFSTAT1_HPTR_M) >> ADC_SSFSTAT1_HPTR_S)
+          - ((stat & ADC_SSFSTAT1_TPTR_M) >> ADC_SSFSTAT1_TPTR_S)) & 3;
+}
+
+// Read up to max results already in the SS1 FIFO without waiting
+// Returns the number of samples written to dst
+uint8_t readAdc0Ss1Block(int16_t *dst, uint8_t max)
+{
+    uint8_t count = getAdc0Ss1FifoCount();
+    uint8_t i;
+    if (count > max)
+        count = max;
+    for (i = 0; i < count; i++)
+        dst[i] = ADC0_SSFIFO1_R;
+    return count;
+}
+
+// Read whole sequences of steps results from the SS1 FIFO into one array
+// per step (dst[step][n]), without waiting
+// Returns the number of sequences read; a partial sequence is left in the FIFO
+uint8_t readAdc0Ss1Deinterleaved(int16_t *dst[], uint8_t steps, uint8_t maxSequences)
+{
+    uint8_t count = getAdc0Ss1FifoCount() / steps;
+    uint8_t i, j;
+    if (count > maxSequences)
+        count = maxSequences;
+    for (i = 0; i < count; i++)
+        for (j = 0; j < steps; j++)
+            dst[j][i] = ADC0_SSFIFO1_R;
+    return count;
+}
+
+// Raise the SS1 interrupt after every n-th step of a count step sequence
+// (the last step always interrupts so the sequence is never left unread)
+void setAdc0Ss1InterruptEvery(uint8_t n, uint8_t count)
+{
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC0_SSCTL1_R = encodeAdcSsCtl(count, n);
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Move SS1 results to two alternating blocks of count samples with uDMA
+// count should be a multiple of the FIFO results per sequence so each block
+// starts on the first step
+// The SS1 vector then fires once per filled block instead of once per sequence
+void initAdc0Ss1Dma(int16_t *ping, int16_t *pong, uint16_t count)
+{
+    adc0DmaBlock[0] = ping;
+    adc0DmaBlock[1] = pong;
+
+    initUdma();
+    UDMA_CHMAP1_R &= ~UDMA_CHMAP1_CH15SEL_M;         // channel 15 is ADC0 SS1 (encoding 0)
+
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    while (ADC0_ACTSS_R & ADC_ACTSS_BUSY);           // let a sequence in progress finish
+    while (!(ADC0_SSFSTAT1_R & ADC_SSFSTAT1_EMPTY))
+        ADC0_SSFIFO1_R;                              // flush so blocks start on MIC1
+    ADC0_IM_R &= ~ADC_IM_MASK1;                      // no per-sequence interrupt, only uDMA done
+    ADC0_ISC_R = ADC_ISC_IN1;
+    startUdmaPingPong16(UDMA_CH_ADC0_SS1, &ADC0_SSFIFO1_R, ping, pong, count);
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Return the next filled block (oldest first), or 0 if none is ready
+// Call from the SS1 interrupt until it returns 0
+int16_t* getAdc0Ss1DmaBlock()
+{
+    int8_t half;
+    clearUdmaChannelInterrupt(UDMA_CH_ADC0_SS1);
+    half = serviceUdmaPingPong(UDMA_CH_ADC0_SS1);
+    if (half < 0)
+        return 0;
+    return adc0DmaBlock[half];
+}
+
+// Number of times both blocks filled before the ISR released one
+uint32_t getAdc0Ss1DmaStallCount()
+{
+    return getUdmaStallCount(UDMA_CH_ADC0_SS1);
+}
+
+// Configure digital comparator comp (0-7) to interrupt once when a sample
+// reaches high, re-arming only after a sample falls below low (hysteresis)
+void setAdc0Comparator(uint8_t comp, uint16_t high, uint16_t low)
+{
+    volatile uint32_t* ctl = &ADC0_DCCTL0_R;
+    volatile uint32_t* cmp = &ADC0_DCCMP0_R;
+    ctl[comp] = ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_HIGH | ADC_DCCTL0_CIM_HONCE;
+    cmp[comp] = ((uint32_t)(high & 0xFFF) << ADC_DCCMP0_COMP1_S) | (low & 0xFFF);
+    ADC0_DCRIC_R = ADC_DCRIC_DCINT0 << comp;         // reset comparator state
+}
+
+// Send SS1 step results to comparator comp instead of the FIFO
+void setAdc0Ss1StepComparator(uint8_t step, uint8_t comp)
+{
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC0_SSDC1_R = (ADC0_SSDC1_R & ~(ADC_SSDC1_S0DCSEL_M << (step * 4))) | ((uint32_t)comp << (step * 4));
+    ADC0_SSOP1_R |= ADC_SSOP1_S0DCOP << (step * 4);
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Return all SS1 steps to the FIFO
+void clearAdc0Ss1StepComparators()
+{
+    ADC0_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC0_SSOP1_R = 0;
+    ADC0_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Route digital comparator interrupts to the SS1 interrupt
+void enableAdc0ComparatorInterrupt()
+{
+    ADC0_IM_R |= ADC_IM_DCONSS1;
+}
+
+// Return and clear the comparators that have interrupted (bit n = comp n)
+uint8_t clearAdc0ComparatorInterrupt()
+{
+    uint8_t status = ADC0_DCISC_R;
+    ADC0_DCISC_R = status;
+    ADC0_ISC_R = ADC_ISC_DCINSS1;
+    return status;
+}
+
+// Count and clear FIFO overflow/underflow flags for all sequencers
+// Returns true if any sample was lost (overflow) or over-read (underflow)
+bool updateAdc0LossCounters()
+{
+    uint8_t ov = ADC0_OSTAT_R & 0xF;
+    uint8_t uv = ADC0_USTAT_R & 0xF;
+    uint8_t ss;
+    for (ss = 0; ss < 4; ss++)
+    {
+        if (ov & (ADC_OSTAT_OV0 << ss))
+            adc0Overflows[ss]++;
+        if (uv & (ADC_USTAT_UV0 << ss))
+            adc0Underflows[ss]++;
+    }
+    ADC0_OSTAT_R = ov;                               // write 1 to clear
+    ADC0_USTAT_R = uv;
+    return (ov | uv) != 0;
+}
+
+uint32_t getAdc0OverflowCount(uint8_t ss)
+{
+    return adc0Overflows[ss & 3];
+}
+
+uint32_t getAdc0UnderflowCount(uint8_t ss)
+{
+    return adc0Underflows[ss & 3];
+}
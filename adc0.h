@@ -10,7 +10,7 @@
 // System Clock:    -
 
 // Hardware configuration:
-// ADC0 SS3
+// ADC0 SS1, triggered by processor (PSSI) or Timer 1A
 
 //-----------------------------------------------------------------------------
 // Device includes, defines, and assembler directives
@@ -24,8 +24,29 @@
 //-----------------------------------------------------------------------------
 
 void initAdc0Ss1();
+void initAdc0Ss1Timed(uint32_t rateHz);
+void setAdc0Ss1Rate(uint32_t rateHz);
+uint32_t getAdc0Ss1Rate();
+bool setAdc0ConversionRate(uint32_t sps);
 void setAdc0Ss1Log2AverageCount(uint8_t log2AverageCount);
-void setAdc0Ss1Mux();
+bool setAdc0Sequence(uint8_t ss, const uint8_t ain[], uint8_t count);
+bool setAdc0Ss1Sequence(const uint8_t ain[], uint8_t count);
+uint32_t getAdc0Ss1StepNs();
 int16_t readAdc0Ss1();
+uint8_t getAdc0Ss1FifoCount();
+uint8_t readAdc0Ss1Block(int16_t *dst, uint8_t max);
+uint8_t readAdc0Ss1Deinterleaved(int16_t *dst[], uint8_t steps, uint8_t maxSequences);
+void setAdc0Ss1InterruptEvery(uint8_t n, uint8_t count);
+void initAdc0Ss1Dma(int16_t *ping, int16_t *pong, uint16_t count);
+int16_t* getAdc0Ss1DmaBlock();
+uint32_t getAdc0Ss1DmaStallCount();
+void setAdc0Comparator(uint8_t comp, uint16_t high, uint16_t low);
+void setAdc0Ss1StepComparator(uint8_t step, uint8_t comp);
+void clearAdc0Ss1StepComparators();
+void enableAdc0ComparatorInterrupt();
+uint8_t clearAdc0ComparatorInterrupt();
+bool updateAdc0LossCounters();
+uint32_t getAdc0OverflowCount(uint8_t ss);
+uint32_t getAdc0UnderflowCount(uint8_t ss);
 
 #endif
@@ -0,0 +1,237 @@
+// ADC1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// ADC1 SS1, triggered by processor (PSSI), Timer 1A, or together with ADC0
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "adc1.h"
+#include "udma.h"
+#include "adcseq.h"
+
+#define ADC_CTL_DITHER          0x00000040
+
+// uDMA channel 25, encoding 1 is ADC1 SS1
+#define UDMA_CH_ADC1_SS1        25
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Ping-pong sample blocks filled by uDMA
+int16_t *adc1DmaBlock[2];
+
+// Loss events per sequencer (checks that found the OSTAT/USTAT bit set)
+uint32_t adc1Overflows[4];
+uint32_t adc1Underflows[4];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize Hardware
+void initAdc1Ss1()
+{
+    // Enable clocks
+    SYSCTL_RCGCADC_R |= SYSCTL_RCGCADC_R1;
+    _delay_cycles(16);
+
+    // Configure ADC
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_CC_R = ADC_CC_CS_SYSPLL;                    // select PLL as the time base (same as ADC0)
+    ADC1_PC_R = ADC_PC_SR_1M;                        // select 1Msps rate
+    ADC1_EMUX_R = ADC_EMUX_EM1_PROCESSOR;            // select SS1 bit in ADCPSSI as trigger
+    ADC1_SSMUX1_R = 0;                               // single step on AIN0 until a sequence is set
+    ADC1_SSCTL1_R = encodeAdcSsCtl(1, 0);
+    ADC1_IM_R = 0;                                   // ADC1 is serviced from the ADC0 SS1 interrupt
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Start SS1 from the Timer 1A trigger, which also reaches ADC0, so both
+// converters begin their first step on the same clock edge
+void selectAdc1Ss1TimerTrigger()
+{
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_EMUX_R = (ADC1_EMUX_R & ~ADC_EMUX_EM1_M) | ADC_EMUX_EM1_TIMER;
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Set the converter rate (125000, 250000, 500000 or 1000000 samples/s)
+// Returns false and leaves the rate unchanged for any other value
+bool setAdc1ConversionRate(uint32_t sps)
+{
+    uint32_t pc;
+    switch (sps)
+    {
+        case 125000:  pc = ADC_PC_SR_125K; break;
+        case 250000:  pc = ADC_PC_SR_250K; break;
+        case 500000:  pc = ADC_PC_SR_500K; break;
+        case 1000000: pc = ADC_PC_SR_1M;   break;
+        default:      return false;
+    }
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_PC_R = pc;
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+    return true;
+}
+
+// Set SS1 input sample average count
+void setAdc1Ss1Log2AverageCount(uint8_t log2AverageCount)
+{
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_SAC_R = log2AverageCount;                   // sample HW averaging
+    if (log2AverageCount == 0)
+        ADC1_CTL_R &= ~ADC_CTL_DITHER;               // turn-off dithering if no averaging
+    else
+        ADC1_CTL_R |= ADC_CTL_DITHER;                // turn-on dithering if averaging
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Set the analog inputs of sequencer ss (0-2) from a list of count AIN
+// numbers in step order; returns false if the list does not fit
+bool setAdc1Sequence(uint8_t ss, const uint8_t ain[], uint8_t count)
+{
+    volatile uint32_t* p = &ADC1_SSMUX0_R;           // SSMUXn/SSCTLn repeat every 8 words
+    if (ss > 2 || count == 0 || count > getAdcSequencerDepth(ss))
+        return false;
+
+    ADC1_ACTSS_R &= ~(ADC_ACTSS_ASEN0 << ss);        // disable sample sequencer for programming
+    p[ss * 8] = encodeAdcSsMux(ain, count);
+    p[ss * 8 + 1] = encodeAdcSsCtl(count, 0);
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN0 << ss;           // enable sample sequencer for operation
+    return true;
+}
+
+// Set SS1 analog inputs from a list of count AIN numbers (1 to 4 steps)
+bool setAdc1Ss1Sequence(const uint8_t ain[], uint8_t count)
+{
+    return setAdc1Sequence(1, ain, count);
+}
+
+// Read one sample from SS1
+int16_t readAdc1Ss1()
+{
+    while (ADC1_ACTSS_R & ADC_ACTSS_BUSY);           // wait until SS1 is not busy
+    while (ADC1_SSFSTAT1_R & ADC_SSFSTAT1_EMPTY);
+    return ADC1_SSFIFO1_R;                           // get single result from the FIFO
+}
+
+// Move SS1 results to two alternating blocks of count samples with uDMA
+// initUdma() must already have been called (see initAdc0Ss1Dma)
+void initAdc1Ss1Dma(int16_t *ping, int16_t *pong, uint16_t count)
+{
+    adc1DmaBlock[0] = ping;
+    adc1DmaBlock[1] = pong;
+
+    UDMA_CHMAP3_R = (UDMA_CHMAP3_R & ~UDMA_CHMAP3_CH25SEL_M) | (1 << UDMA_CHMAP3_CH25SEL_S);
+                                                     // channel 25 is ADC1 SS1 (encoding 1)
+
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    while (ADC1_ACTSS_R & ADC_ACTSS_BUSY);           // let a sequence in progress finish
+    while (!(ADC1_SSFSTAT1_R & ADC_SSFSTAT1_EMPTY))
+        ADC1_SSFIFO1_R;                              // flush so blocks start on the first step
+    ADC1_ISC_R = ADC_ISC_IN1;
+    startUdmaPingPong16(UDMA_CH_ADC1_SS1, &ADC1_SSFIFO1_R, ping, pong, count);
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Return the next filled block (oldest first), or 0 if none is ready
+int16_t* getAdc1Ss1DmaBlock()
+{
+    int8_t half;
+    clearUdmaChannelInterrupt(UDMA_CH_ADC1_SS1);
+    half = serviceUdmaPingPong(UDMA_CH_ADC1_SS1);
+    if (half < 0)
+        return 0;
+    return adc1DmaBlock[half];
+}
+
+uint32_t getAdc1Ss1DmaStallCount()
+{
+    return getUdmaStallCount(UDMA_CH_ADC1_SS1);
+}
+
+// Configure digital comparator comp (0-7) to interrupt once when a sample
+// reaches high, re-arming only after a sample falls below low (hysteresis)
+void setAdc1Comparator(uint8_t comp, uint16_t high, uint16_t low)
+{
+    volatile uint32_t* ctl = &ADC1_DCCTL0_R;
+    volatile uint32_t* cmp = &ADC1_DCCMP0_R;
+    ctl[comp] = ADC_DCCTL0_CIE | ADC_DCCTL0_CIC_HIGH | ADC_DCCTL0_CIM_HONCE;
+    cmp[comp] = ((uint32_t)(high & 0xFFF) << ADC_DCCMP0_COMP1_S) | (low & 0xFFF);
+    ADC1_DCRIC_R = ADC_DCRIC_DCINT0 << comp;         // reset comparator state
+}
+
+// Send SS1 step results to comparator comp instead of the FIFO
+void setAdc1Ss1StepComparator(uint8_t step, uint8_t comp)
+{
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_SSDC1_R = (ADC1_SSDC1_R & ~(ADC_SSDC1_S0DCSEL_M << (step * 4))) | ((uint32_t)comp << (step * 4));
+    ADC1_SSOP1_R |= ADC_SSOP1_S0DCOP << (step * 4);
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Return all SS1 steps to the FIFO
+void clearAdc1Ss1StepComparators()
+{
+    ADC1_ACTSS_R &= ~ADC_ACTSS_ASEN1;                // disable sample sequencer 1 (SS1) for programming
+    ADC1_SSOP1_R = 0;
+    ADC1_ACTSS_R |= ADC_ACTSS_ASEN1;                 // enable SS1 for operation
+}
+
+// Route digital comparator interrupts to the SS1 interrupt
+void enableAdc1ComparatorInterrupt()
+{
+    ADC1_IM_R |= ADC_IM_DCONSS1;
+}
+
+// Return and clear the comparators that have interrupted (bit n = comp n)
+uint8_t clearAdc1ComparatorInterrupt()
+{
+    uint8_t status = ADC1_DCISC_R;
+    ADC1_DCISC_R = status;
+    ADC1_ISC_R = ADC_ISC_DCINSS1;
+    return status;
+}
+
+// Count and clear FIFO overflow/underflow flags for all sequencers
+// Returns true if any sample was lost (overflow) or over-read (underflow)
+bool updateAdc1LossCounters()
+{
+    uint8_t ov = ADC1_OSTAT_R & 0xF;
+    uint8_t uv = ADC1_USTAT_R & 0xF;
+    uint8_t ss;
+    for (ss = 0; ss < 4; ss++)
+    {
+        if (ov & (ADC_OSTAT_OV0 << ss))
+            adc1Overflows[ss]++;
+        if (uv & (ADC_USTAT_UV0 << ss))
+            adc1Underflows[ss]++;
+    }
+    ADC1_OSTAT_R = ov;                               // write 1 to clear
+    ADC1_USTAT_R = uv;
+    return (ov | uv) != 0;
+}
+
+uint32_t getAdc1OverflowCount(uint8_t ss)
+{
+    return adc1Overflows[ss & 3];
+}
+
+uint32_t getAdc1UnderflowCount(uint8_t ss)
+{
+    return adc1Underflows[ss & 3];
+}
@@ -0,0 +1,44 @@
+// ADC1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// ADC1 SS1, triggered by processor (PSSI), Timer 1A, or together with ADC0
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef ADC1_H_
+#define ADC1_H_
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initAdc1Ss1();
+void selectAdc1Ss1TimerTrigger();
+bool setAdc1ConversionRate(uint32_t sps);
+void setAdc1Ss1Log2AverageCount(uint8_t log2AverageCount);
+bool setAdc1Sequence(uint8_t ss, const uint8_t ain[], uint8_t count);
+bool setAdc1Ss1Sequence(const uint8_t ain[], uint8_t count);
+int16_t readAdc1Ss1();
+void initAdc1Ss1Dma(int16_t *ping, int16_t *pong, uint16_t count);
+int16_t* getAdc1Ss1DmaBlock();
+uint32_t getAdc1Ss1DmaStallCount();
+void setAdc1Comparator(uint8_t comp, uint16_t high, uint16_t low);
+void setAdc1Ss1StepComparator(uint8_t step, uint8_t comp);
+void clearAdc1Ss1StepComparators();
+void enableAdc1ComparatorInterrupt();
+uint8_t clearAdc1ComparatorInterrupt();
+bool updateAdc1LossCounters();
+uint32_t getAdc1OverflowCount(uint8_t ss);
+uint32_t getAdc1UnderflowCount(uint8_t ss);
+
+#endif
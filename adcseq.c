@@ -0,0 +1,67 @@
+// ADC Sequence Encoder Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "adcseq.h"
+
+// Per-step SSCTL bits (each step uses 4 bits: TS, IE, END, D)
+#define SSCTL_END 0x2
+#define SSCTL_IE  0x4
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// FIFO depth (steps) of sequencer ss; the caller picks the sequencer, since
+// the uDMA channel and interrupt vector come with it (0 = no such sequencer)
+uint8_t getAdcSequencerDepth(uint8_t ss)
+{
+    switch (ss)
+    {
+        case 0:  return ADC_SS0_DEPTH;
+        case 1:  return ADC_SS1_DEPTH;
+        case 2:  return ADC_SS2_DEPTH;
+        case 3:  return ADC_SS3_DEPTH;
+        default: return 0;
+    }
+}
+
+// SSMUXn value for a list of AIN numbers in step order (repeats allowed)
+uint32_t encodeAdcSsMux(const uint8_t ain[], uint8_t count)
+{
+    uint32_t mux = 0;
+    uint8_t i;
+    for (i = 0; i < count && i < ADC_SS0_DEPTH; i++)
+        mux |= (uint32_t)(ain[i] & 0xF) << (i * 4);
+    return mux;
+}
+
+// SSCTLn value for count steps: END on the last step, IE on every
+// interruptEvery-th step and always on the last (0 = last step only)
+uint32_t encodeAdcSsCtl(uint8_t count, uint8_t interruptEvery)
+{
+    uint32_t ctl;
+    uint8_t i;
+    if (count == 0)
+        return 0;
+    if (count > ADC_SS0_DEPTH)
+        count = ADC_SS0_DEPTH;
+    ctl = (uint32_t)(SSCTL_END | SSCTL_IE) << ((count - 1) * 4);
+    if (interruptEvery > 0)
+        for (i = interruptEvery - 1; i < count; i += interruptEvery)
+            ctl |= (uint32_t)SSCTL_IE << (i * 4);
+    return ctl;
+}
@@ -0,0 +1,36 @@
+// ADC Sequence Encoder Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef ADCSEQ_H_
+#define ADCSEQ_H_
+
+#include <stdint.h>
+
+// Sample sequencer FIFO depths
+#define ADC_SS0_DEPTH 8
+#define ADC_SS1_DEPTH 4
+#define ADC_SS2_DEPTH 4
+#define ADC_SS3_DEPTH 1
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint8_t getAdcSequencerDepth(uint8_t ss);
+uint32_t encodeAdcSsMux(const uint8_t ain[], uint8_t count);
+uint32_t encodeAdcSsCtl(uint8_t count, uint8_t interruptEvery);
+
+#endif
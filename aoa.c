@@ -0,0 +1,286 @@
+// Angle of Arrival Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdoa.h"
+#include "aoa.h"
+
+#define CORDIC_STEPS 16
+
+// 1/sqrt(3) in Q15
+#define INV_SQRT3_Q15 18919
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// atan(2^-i) in degrees, Q16
+const int32_t cordicAngle[CORDIC_STEPS] =
+{
+    2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+    14668, 7334, 3667, 1833, 917, 458, 229, 115
+};
+
+// Angle (Q8) for each whole-sample (lag12, lag13) pair, or AOA_INVALID
+uint32_t aoaTable[AOA_TABLE_SIZE][AOA_TABLE_SIZE];
+int16_t aoaTableMaxLag = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Angle of (x, y) in degrees Q8, -180 < angle <= 180 (0 for the origin)
+// CORDIC vectoring: after folding into the right half plane, each step
+// rotates the vector by -/+atan(2^-i) toward the x axis and accumulates
+// the rotation; accurate to about 0.01 degree
+int32_t atan2DegQ8(int32_t y, int32_t x)
+{
+    int32_t angle = 0;
+    int32_t t;
+    uint32_t mag;
+    uint8_t i;
+
+    if (x == 0 && y == 0)
+        return 0;
+
+    //work at full precision without overflow (gain is 1.65, keep below 2^29)
+    mag = (x < 0 ? -(uint32_t)x : (uint32_t)x) | (y < 0 ? -(uint32_t)y : (uint32_t)y);
+    while (mag >= (1u << 29))
+    {
+        x >>= 1;
+        y >>= 1;
+        mag >>= 1;
+    }
+    while (mag < (1u << 28))
+    {
+        x <<= 1;
+        y <<= 1;
+        mag <<= 1;
+    }
+
+    if (x < 0)
+    {
+        //rotate by 180 degrees
+        x = -x;
+        y = -y;
+        angle = 180 << 16;
+    }
+
+    for (i = 0; i < CORDIC_STEPS; i++)
+    {
+        t = x;
+        if (y > 0)
+        {
+            x += y >> i;
+            y -= t >> i;
+            angle += cordicAngle[i];
+        }
+        else
+        {
+            x -= y >> i;
+            y += t >> i;
+            angle -= cordicAngle[i];
+        }
+    }
+
+    //wrap after rounding so that -180 comes back as 180
+    angle = (angle + (1 << 7)) >> 8;
+    if (angle > 180 * AOA_DEG_Q8)
+        angle -= 360 * AOA_DEG_Q8;
+    if (angle <= -180 * AOA_DEG_Q8)
+        angle += 360 * AOA_DEG_Q8;
+    return angle;
+}
+
+// Direction of a far-field source from the MIC1-MIC2 and MIC1-MIC3 delays
+// (any common unit, e.g. 1/256 sample)
+// With unit vector u toward the source and mic positions p, the delay of
+// mic j after mic i is (p_i - p_j) . u / c; for this geometry that gives
+// cos(a) ~ tdoa12 - tdoa13 and sin(a) ~ (tdoa12 + tdoa13) / sqrt(3) with
+// the same scale, so neither the spacing nor the speed of sound is needed
+// Both components keep the 15 fraction bits of the 1/sqrt(3) product, so
+// short delay vectors do not lose their direction to truncation
+// Returns degrees in Q8, 0 <= angle < 360
+uint32_t getAoaDegQ8(int32_t tdoa12Q8, int32_t tdoa13Q8)
+{
+    int64_t x = ((int64_t)tdoa12Q8 - tdoa13Q8) << 15;
+    int64_t y = ((int64_t)tdoa12Q8 + tdoa13Q8) * INV_SQRT3_Q15;
+    int32_t angle;
+
+    while (x > INT32_MAX || x < -INT32_MAX || y > INT32_MAX || y < -INT32_MAX)
+    {
+        x >>= 1;
+        y >>= 1;
+    }
+    angle = atan2DegQ8(y, x);
+    if (angle < 0)
+        angle += 360 * AOA_DEG_Q8;
+    return angle;
+}
+
+// Integer square root (floor)
+uint32_t sqrtU64(uint64_t x)
+{
+    uint64_t root = 0, bit = (uint64_t)1 << 62;
+    while (bit > x)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (x >= root + bit)
+        {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Largest distance between two of the three mics (mm, rounded up)
+uint32_t getMaxMicSpacingMm(const int16_t *xMm, const int16_t *yMm)
+{
+    uint32_t d2, max2 = 0, d;
+    int32_t dx, dy;
+    uint8_t i, j;
+    for (i = 0; i < 3; i++)
+        for (j = i + 1; j < 3; j++)
+        {
+            dx = xMm[i] - xMm[j];
+            dy = yMm[i] - yMm[j];
+            d2 = dx * dx + dy * dy;
+            if (d2 > max2)
+                max2 = d2;
+        }
+    d = sqrtU64(max2);
+    return d * d < max2 ? d + 1 : d;
+}
+
+// Least-squares far-field direction from all three pairwise delays
+// (tdoaQ8[] for pairs 1-2, 1-3, 2-3 in 1/256 sample, mic positions in mm)
+// Each delay is (p_a - p_b) . s for the slowness vector s = u / c, so the
+// rows A_k = p_a - p_b give the normal equations (A'A) s = A' tdoa; s is
+// only needed up to a positive scale for the angle, so adj(A'A) A' tdoa
+// stands in for it, and the residual is the RMS of tdoa - A s (1/256
+// sample), which is near zero when the three delays agree
+// Returns false when the mics are collinear or the delays are all zero
+bool solveAoa(const int16_t *xMm, const int16_t *yMm, const int32_t *tdoaQ8,
+              uint32_t *angleQ8, uint32_t *residualQ8)
+{
+    static const uint8_t pair[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    int32_t ax[3], ay[3];
+    int64_t mxx = 0, mxy = 0, myy = 0, bx = 0, by = 0;
+    int64_t det, sx, sy, e;
+    uint64_t sum = 0;
+    int32_t angle;
+    uint8_t k;
+
+    for (k = 0; k < 3; k++)
+    {
+        ax[k] = xMm[pair[k][0]] - xMm[pair[k][1]];
+        ay[k] = yMm[pair[k][0]] - yMm[pair[k][1]];
+        mxx += ax[k] * ax[k];
+        mxy += ax[k] * ay[k];
+        myy += ay[k] * ay[k];
+        bx += (int64_t)ax[k] * tdoaQ8[k];
+        by += (int64_t)ay[k] * tdoaQ8[k];
+    }
+    det = mxx * myy - mxy * mxy;
+    if (det <= 0)
+        return false;
+    sx = myy * bx - mxy * by;
+    sy = mxx * by - mxy * bx;
+    if (sx == 0 && sy == 0)
+        return false;
+
+    //predicted delay A_k s / det against the measured one
+    for (k = 0; k < 3; k++)
+    {
+        e = tdoaQ8[k] - (ax[k] * sx + ay[k] * sy) / det;
+        sum += e * e;
+    }
+    *residualQ8 = sqrtU64(sum / 3);
+
+    //bring the vector into 32 bits for CORDIC, keeping its direction
+    while (sx > INT32_MAX || sx < -INT32_MAX || sy > INT32_MAX || sy < -INT32_MAX)
+    {
+        sx >>= 1;
+        sy >>= 1;
+    }
+    angle = atan2DegQ8(sy, sx);
+    if (angle < 0)
+        angle += 360 * AOA_DEG_Q8;
+    *angleQ8 = angle;
+    return true;
+}
+
+// Fill the lookup table from getAoaDegQ8 for the given geometry and rate;
+// call again whenever either changes
+// A far-field source puts (lag12 - lag13, (lag12 + lag13) / sqrt(3)) on a
+// circle of radius D = spacing * rate / c samples; pairs more than one
+// sample off that circle cannot come from one wavefront and are invalid
+// Returns false if the lags can exceed the table
+bool initAoaTable(uint32_t spacingMm, uint32_t sampleRateHz)
+{
+    int16_t maxLag = getMaxTdoaLag(spacingMm, sampleRateHz);
+    int32_t dQ8 = ((uint64_t)spacingMm * sampleRateHz * AOA_DEG_Q8) / SPEED_OF_SOUND_MM;
+    int32_t lowQ8 = dQ8 > 256 ? dQ8 - 256 : 0;
+    int32_t highQ8 = dQ8 + 256;
+    int64_t r2, low2, high2;
+    int16_t i, j;
+    int32_t x, s;
+
+    aoaTableMaxLag = 0;
+    if (maxLag > AOA_TABLE_MAX_LAG)
+        return false;
+
+    //compare 3 r^2 = 3 x^2 + s^2 (s = lag12 + lag13) against 3 D^2 in Q16
+    low2 = 3 * (int64_t)lowQ8 * lowQ8;
+    high2 = 3 * (int64_t)highQ8 * highQ8;
+    for (i = -AOA_TABLE_MAX_LAG; i <= AOA_TABLE_MAX_LAG; i++)
+    {
+        for (j = -AOA_TABLE_MAX_LAG; j <= AOA_TABLE_MAX_LAG; j++)
+        {
+            x = i - j;
+            s = i + j;
+            r2 = ((int64_t)3 * x * x + (int64_t)s * s) << 16;
+            if (r2 < low2 || r2 > high2 || r2 == 0)
+                aoaTable[i + AOA_TABLE_MAX_LAG][j + AOA_TABLE_MAX_LAG] = AOA_INVALID;
+            else
+                aoaTable[i + AOA_TABLE_MAX_LAG][j + AOA_TABLE_MAX_LAG] =
+                    getAoaDegQ8((int32_t)i * 256, (int32_t)j * 256);
+        }
+    }
+    aoaTableMaxLag = maxLag;
+    return true;
+}
+
+// Angle (Q8) for whole-sample lags by one table load
+// Returns false for lags outside the table or a pair no source can produce
+bool lookupAoa(int16_t lag12, int16_t lag13, uint32_t *angleQ8)
+{
+    uint32_t angle;
+    if (lag12 < -aoaTableMaxLag || lag12 > aoaTableMaxLag
+        || lag13 < -aoaTableMaxLag || lag13 > aoaTableMaxLag)
+        return false;
+    angle = aoaTable[lag12 + AOA_TABLE_MAX_LAG][lag13 + AOA_TABLE_MAX_LAG];
+    if (angle == AOA_INVALID)
+        return false;
+    *angleQ8 = angle;
+    return true;
+}
@@ -0,0 +1,48 @@
+// Angle of Arrival Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef AOA_H_
+#define AOA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Angles are degrees in Q8
+#define AOA_DEG_Q8 256
+
+// Whole-sample lag pairs covered by the lookup table (+/-max per pair)
+#define AOA_TABLE_MAX_LAG 8
+#define AOA_TABLE_SIZE    (2 * AOA_TABLE_MAX_LAG + 1)
+#define AOA_INVALID       0xFFFFFFFF
+
+// Angles are measured counterclockwise from +x in the mic coordinate frame
+// getAoaDegQ8 and the table assume an equilateral triangle: MIC1 at the
+// apex on +y, MIC2 at lower left and MIC3 at lower right; solveAoa takes
+// any positions
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int32_t atan2DegQ8(int32_t y, int32_t x);
+uint32_t getAoaDegQ8(int32_t tdoa12Q8, int32_t tdoa13Q8);
+uint32_t getMaxMicSpacingMm(const int16_t *xMm, const int16_t *yMm);
+bool solveAoa(const int16_t *xMm, const int16_t *yMm, const int32_t *tdoaQ8,
+              uint32_t *angleQ8, uint32_t *residualQ8);
+bool initAoaTable(uint32_t spacingMm, uint32_t sampleRateHz);
+bool lookupAoa(int16_t lag12, int16_t lag13, uint32_t *angleQ8);
+
+#endif
@@ -0,0 +1,108 @@
+// Capture Ring Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "capture.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+int16_t captureRing[CAPTURE_MICS][CAPTURE_LEN];
+
+// Total samples written (the ring index is the low bits)
+volatile uint32_t captureCount = 0;
+
+// Held window, valid while captureHeld is set; it becomes ready once the
+// post-trigger samples have been written
+volatile bool captureHeld = false;
+volatile uint32_t captureStart = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initCapture(void)
+{
+    captureCount = 0;
+    captureHeld = false;
+}
+
+// Store one aligned sample per mic, overwriting the oldest
+void writeCapture(int16_t mic1, int16_t mic2, int16_t mic3)
+{
+    uint16_t i = captureCount & CAPTURE_MASK;
+    captureRing[0][i] = mic1;
+    captureRing[1][i] = mic2;
+    captureRing[2][i] = mic3;
+    captureCount++;
+}
+
+// Mark the most recently written sample as the trigger
+// Returns false if a window is already held (the trigger is ignored)
+bool triggerCapture(void)
+{
+    if (captureHeld)
+        return false;
+    captureStart = captureCount - 1 - CAPTURE_PRE;
+    captureHeld = true;
+    return true;
+}
+
+// Return true and describe the held window once all of its samples are in
+// No data is copied; the caller reads the ring through the window indices
+bool getCaptureWindow(CAPTURE_WINDOW *win)
+{
+    if (!captureHeld || (captureCount - captureStart) < (CAPTURE_PRE + CAPTURE_POST))
+        return false;
+    win->start = captureStart;
+    win->length = CAPTURE_PRE + CAPTURE_POST;
+    win->trigger = CAPTURE_PRE;
+    return true;
+}
+
+// Return true and describe the held window as soon as it is triggered,
+// before all of its samples are in
+bool getCaptureHold(CAPTURE_WINDOW *win)
+{
+    if (!captureHeld)
+        return false;
+    win->start = captureStart;
+    win->length = CAPTURE_PRE + CAPTURE_POST;
+    win->trigger = CAPTURE_PRE;
+    return true;
+}
+
+// Hand the window back so the next trigger can be taken
+// Returns false if capture wrapped into the window before it was released,
+// in which case anything computed from it must be discarded
+bool releaseCapture(void)
+{
+    bool intact = (captureCount - captureStart) <= CAPTURE_LEN;
+    captureHeld = false;
+    return intact;
+}
+
+int16_t* getCaptureRing(uint8_t mic)
+{
+    return captureRing[mic];
+}
+
+uint32_t getCaptureCount(void)
+{
+    return captureCount;
+}
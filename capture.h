@@ -0,0 +1,60 @@
+// Capture Ring Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef CAPTURE_H_
+#define CAPTURE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ring length per mic (power of 2); SRAM used is CAPTURE_MICS * CAPTURE_LEN * 2
+// bytes (12 KiB of the 32 KiB with the defaults)
+#define CAPTURE_MICS     3
+#define CAPTURE_LOG2_LEN 11
+#define CAPTURE_LEN      (1 << CAPTURE_LOG2_LEN)
+#define CAPTURE_MASK     (CAPTURE_LEN - 1)
+
+// Samples kept before and after the trigger; the window may use at most half
+// the ring so capture always has the other half to run into
+#define CAPTURE_PRE      256
+#define CAPTURE_POST     768
+
+#if (CAPTURE_PRE + CAPTURE_POST) > (CAPTURE_LEN / 2)
+#error "capture window must fit in half of the ring"
+#endif
+
+// Frozen window: sample k of mic m is ring[m][(start + k) & CAPTURE_MASK]
+typedef struct _CAPTURE_WINDOW
+{
+    uint32_t start;                                  // sample count of the first sample
+    uint16_t length;                                 // CAPTURE_PRE + CAPTURE_POST
+    uint16_t trigger;                                // offset of the trigger sample
+} CAPTURE_WINDOW;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initCapture(void);
+void writeCapture(int16_t mic1, int16_t mic2, int16_t mic3);
+bool triggerCapture(void);
+bool getCaptureWindow(CAPTURE_WINDOW *win);
+bool getCaptureHold(CAPTURE_WINDOW *win);
+bool releaseCapture(void);
+int16_t* getCaptureRing(uint8_t mic);
+uint32_t getCaptureCount(void);
+
+#endif
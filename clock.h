@@ -19,6 +19,8 @@
 #ifndef CLOCK_H_
 #define CLOCK_H_
 
+#define SYSTEM_CLOCK_HZ 40000000
+
 //-----------------------------------------------------------------------------
 // Subroutines
 //-----------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+// Cycle Counter Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// SysTick, free running at the system clock (no interrupt)
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "tm4c123gh6pm.h"
+#include "cycles.h"
+
+// SysTick is a 24-bit down counter
+#define CYCLE_MASK 0x00FFFFFF
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Start SysTick counting system clocks over its full 24-bit range
+// Intervals up to 2^24 clocks (0.42 s at 40 MHz) can be measured
+void initCycleCounter(void)
+{
+    NVIC_ST_CTRL_R = 0;                              // turn-off SysTick for programming
+    NVIC_ST_RELOAD_R = CYCLE_MASK;
+    NVIC_ST_CURRENT_R = 0;                           // any write clears the count
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_CLK_SRC | NVIC_ST_CTRL_ENABLE;
+                                                     // system clock, no interrupt
+}
+
+uint32_t getCycleCount(void)
+{
+    return NVIC_ST_CURRENT_R;
+}
+
+// Clocks since start was read (the counter runs down)
+uint32_t getElapsedCycles(uint32_t start)
+{
+    return (start - NVIC_ST_CURRENT_R) & CYCLE_MASK;
+}
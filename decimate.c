@@ -0,0 +1,74 @@
+// Decimation Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "decimate.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Clear filter state and set the decimation factor (log2Factor = 0 passes
+// every sample through, only scaled to Q3)
+void initCicDecimator(CIC_DECIMATOR *cic, uint8_t log2Factor)
+{
+    uint8_t i;
+    if (log2Factor > CIC_MAX_LOG2_FACTOR)
+        log2Factor = CIC_MAX_LOG2_FACTOR;
+    for (i = 0; i < CIC_ORDER; i++)
+    {
+        cic->integ[i] = 0;
+        cic->comb[i] = 0;
+    }
+    cic->log2Factor = log2Factor;
+    cic->phase = 0;
+}
+
+// Add one input sample; returns true and writes y once every 2^log2Factor
+// inputs. The DC gain of 2^(CIC_ORDER * log2Factor) is traded for the
+// CIC_FRAC_BITS fraction bits with rounding, so y is the input in Q3 while
+// the in-band noise drops with the factor
+bool filterCicDecimator(CIC_DECIMATOR *cic, int16_t x, int16_t *y)
+{
+    uint32_t v;
+    uint32_t prev;
+    uint8_t i;
+    int8_t shift = CIC_ORDER * cic->log2Factor - CIC_FRAC_BITS;
+
+    // Integrators at the input rate
+    cic->integ[0] += (uint32_t)(int32_t)x;
+    cic->integ[1] += cic->integ[0];
+
+    if (++cic->phase < (1 << cic->log2Factor))
+        return false;
+    cic->phase = 0;
+
+    // Combs at the output rate (differential delay of 1)
+    v = cic->integ[CIC_ORDER - 1];
+    for (i = 0; i < CIC_ORDER; i++)
+    {
+        prev = cic->comb[i];
+        cic->comb[i] = v;
+        v -= prev;
+    }
+
+    if (shift <= 0)
+        *y = (int32_t)v << -shift;
+    else
+        *y = ((int32_t)v + (1 << (shift - 1))) >> shift;
+    return true;
+}
@@ -0,0 +1,47 @@
+// Decimation Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef DECIMATE_H_
+#define DECIMATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Second order CIC (sinc^2) decimator, factor 2^log2Factor (up to 2^8)
+#define CIC_ORDER 2
+#define CIC_MAX_LOG2_FACTOR 8
+
+// Output format: input counts in Q3 (1/8 count) at every factor, so the
+// resolution gained by averaging survives; 12-bit input gives 0 to 32760
+#define CIC_FRAC_BITS 3
+#define CIC_ONE (1 << CIC_FRAC_BITS)
+
+typedef struct _CIC_DECIMATOR
+{
+    uint32_t integ[CIC_ORDER];                       // wrap-around arithmetic is intended
+    uint32_t comb[CIC_ORDER];
+    uint8_t log2Factor;
+    uint16_t phase;
+} CIC_DECIMATOR;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initCicDecimator(CIC_DECIMATOR *cic, uint8_t log2Factor);
+bool filterCicDecimator(CIC_DECIMATOR *cic, int16_t x, int16_t *y);
+
+#endif
@@ -0,0 +1,176 @@
+// DSP Kernel Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "dsp.h"
+
+// Packed-pair primitives: TI compiler intrinsics, ACLE intrinsics on GCC or
+// clang, or C emulation of the same instructions elsewhere (host builds)
+#if defined(__TI_ARM__) && defined(__TI_TMS470_V7M4__)
+#define SMLALD(acc, x, y) _smlald(acc, x, y)
+#define QADD16(x, y)      _qadd16(x, y)
+#define SSAT16(x)         _ssatl(x, 0, 16)
+#elif defined(__ARM_FEATURE_SIMD32) && defined(__ARM_FEATURE_SAT)
+#include <arm_acle.h>
+#define SMLALD(acc, x, y) __smlald(x, y, acc)
+#define QADD16(x, y)      __qadd16(x, y)
+#define SSAT16(x)         __ssat(x, 16)
+#else
+#define SMLALD(acc, x, y) smlaldC(acc, x, y)
+#define QADD16(x, y)      qadd16C(x, y)
+#define SSAT16(x)         ssat16C(x)
+#endif
+
+// Two consecutive samples as one word, first sample in the low half
+#define PAIR(p) ((uint32_t)(uint16_t)(p)[0] | ((uint32_t)(uint16_t)(p)[1] << 16))
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int32_t ssat16C(int32_t x)
+{
+    if (x > 32767)
+        return 32767;
+    if (x < -32768)
+        return -32768;
+    return x;
+}
+
+// acc + lo(x) * lo(y) + hi(x) * hi(y)
+int64_t smlaldC(int64_t acc, uint32_t x, uint32_t y)
+{
+    acc += (int32_t)(int16_t)x * (int16_t)y;
+    acc += (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+    return acc;
+}
+
+// Saturating add of each half
+uint32_t qadd16C(uint32_t x, uint32_t y)
+{
+    uint16_t lo = ssat16C((int16_t)x + (int16_t)y);
+    uint16_t hi = ssat16C((int16_t)(x >> 16) + (int16_t)(y >> 16));
+    return lo | ((uint32_t)hi << 16);
+}
+
+// Sum of a[i] * b[i] for i = 0..n-1
+int64_t dotQ15(const int16_t *a, const int16_t *b, uint16_t n)
+{
+    int64_t acc = 0;
+    uint16_t i;
+    for (i = 0; i + 1 < n; i += 2)
+        acc = SMLALD(acc, PAIR(a + i), PAIR(b + i));
+    if (i < n)
+        acc += (int32_t)a[i] * b[i];
+    return acc;
+}
+
+// y[i] = sat16(sum of h[k] * x[i + k] >> 15) for i = 0..count-1, so x
+// holds taps - 1 history samples ahead of the first new one and h is
+// stored oldest tap first (time reversed); up to 65535 taps
+void firQ15(const int16_t *x, int16_t *y, uint16_t count, const int16_t *h, uint16_t taps)
+{
+    uint16_t i;
+    for (i = 0; i < count; i++)
+        y[i] = SSAT16((int32_t)(dotQ15(x + i, h, taps) >> 15));
+}
+
+// Sum of a[i] * b[i + lag] for i = 0..n-1; b must be valid over the
+// shifted range
+int64_t correlateLagQ15(const int16_t *a, const int16_t *b, uint16_t n, int16_t lag)
+{
+    return dotQ15(a, b + lag, n);
+}
+
+// Sum of x[i]^2 for i = 0..n-1
+uint64_t sumSquaresQ15(const int16_t *x, uint16_t n)
+{
+    int64_t acc = 0;
+    uint32_t p;
+    uint16_t i;
+    for (i = 0; i + 1 < n; i += 2)
+    {
+        p = PAIR(x + i);
+        acc = SMLALD(acc, p, p);
+    }
+    if (i < n)
+        acc += (int32_t)x[i] * x[i];
+    return acc;
+}
+
+// y[i] = sat16(a[i] + b[i]); y may be a or b
+void addSatQ15(const int16_t *a, const int16_t *b, int16_t *y, uint16_t n)
+{
+    uint32_t s;
+    uint16_t i;
+    for (i = 0; i + 1 < n; i += 2)
+    {
+        s = QADD16(PAIR(a + i), PAIR(b + i));
+        y[i] = s;
+        y[i + 1] = s >> 16;
+    }
+    if (i < n)
+        y[i] = SSAT16(a[i] + b[i]);
+}
+
+// Scalar references for the kernels above
+
+int64_t dotQ15Ref(const int16_t *a, const int16_t *b, uint16_t n)
+{
+    int64_t acc = 0;
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        acc += (int32_t)a[i] * b[i];
+    return acc;
+}
+
+void firQ15Ref(const int16_t *x, int16_t *y, uint16_t count, const int16_t *h, uint16_t taps)
+{
+    int64_t acc;
+    uint16_t i, k;
+    for (i = 0; i < count; i++)
+    {
+        acc = 0;
+        for (k = 0; k < taps; k++)
+            acc += (int32_t)h[k] * x[i + k];
+        y[i] = ssat16C((int32_t)(acc >> 15));
+    }
+}
+
+int64_t correlateLagQ15Ref(const int16_t *a, const int16_t *b, uint16_t n, int16_t lag)
+{
+    int64_t acc = 0;
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        acc += (int32_t)a[i] * b[i + lag];
+    return acc;
+}
+
+uint64_t sumSquaresQ15Ref(const int16_t *x, uint16_t n)
+{
+    uint64_t acc = 0;
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        acc += (int32_t)x[i] * x[i];
+    return acc;
+}
+
+void addSatQ15Ref(const int16_t *a, const int16_t *b, int16_t *y, uint16_t n)
+{
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        y[i] = ssat16C(a[i] + b[i]);
+}
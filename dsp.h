@@ -0,0 +1,56 @@
+// DSP Kernel Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef DSP_H_
+#define DSP_H_
+
+#include <stdint.h>
+
+// Q15 kernels that work on int16 pairs with the Cortex-M4 SIMD instructions
+// (SMLALD, QADD16, SSAT) when built for the M4 and emulate those
+// instructions in C otherwise; the *Ref versions are plain scalar loops
+// that the packed versions must match bit for bit on any build
+//
+// Estimated cycles at 0 wait states (n samples, t taps):
+//
+//   kernel              packed (M4)        Ref (M4, scalar)
+//   dotQ15              ~2.5 n + 12        ~4 n + 10
+//   firQ15 (per out)    ~2.5 t + 20        ~4 t + 18
+//   correlateLagQ15     ~2.5 n + 14        ~4 n + 12
+//   sumSquaresQ15       ~1.5 n + 10        ~3 n + 10
+//   addSatQ15           ~3 n + 10          ~6 n + 10
+//
+// At 40 MHz one 64-step sequence block of three mics at 20 kHz leaves
+// 3.2 ms (128000 cycles) per block, so e.g. a 32-tap FIR on all three mics
+// costs about 64 * 3 * 100 = 19200 cycles (15%) per block
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int64_t dotQ15(const int16_t *a, const int16_t *b, uint16_t n);
+void firQ15(const int16_t *x, int16_t *y, uint16_t count, const int16_t *h, uint16_t taps);
+int64_t correlateLagQ15(const int16_t *a, const int16_t *b, uint16_t n, int16_t lag);
+uint64_t sumSquaresQ15(const int16_t *x, uint16_t n);
+void addSatQ15(const int16_t *a, const int16_t *b, int16_t *y, uint16_t n);
+
+int64_t dotQ15Ref(const int16_t *a, const int16_t *b, uint16_t n);
+void firQ15Ref(const int16_t *x, int16_t *y, uint16_t count, const int16_t *h, uint16_t taps);
+int64_t correlateLagQ15Ref(const int16_t *a, const int16_t *b, uint16_t n, int16_t lag);
+uint64_t sumSquaresQ15Ref(const int16_t *x, uint16_t n);
+void addSatQ15Ref(const int16_t *a, const int16_t *b, int16_t *y, uint16_t n);
+
+#endif
@@ -0,0 +1,56 @@
+// Exponential Moving Average Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "ema.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Nearest power of two time constant (in samples) for a time constant in ms
+uint8_t getEmaLog2Tau(uint32_t timeConstantMs, uint32_t sampleRateHz)
+{
+    uint32_t samples = (uint64_t)timeConstantMs * sampleRateHz / 1000;
+    uint8_t log2Tau = 0;
+    //round up when samples is at least 1.5 * 2^log2Tau (compared doubled,
+    //so 1 sample stays 2^0)
+    while (log2Tau < EMA_MAX_LOG2_TAU && (uint64_t)samples * 2 >= (3u << log2Tau))
+        log2Tau++;
+    return log2Tau;
+}
+
+// Set the time constant and start the average at y
+void initEma(EMA *ema, uint8_t log2Tau, int16_t y)
+{
+    if (log2Tau > EMA_MAX_LOG2_TAU)
+        log2Tau = EMA_MAX_LOG2_TAU;
+    ema->log2Tau = log2Tau;
+    ema->acc = (int32_t)y << log2Tau;
+}
+
+// acc holds the average scaled by 2^log2Tau, so the update is two shifts
+// and two adds with no loss of the fraction between samples
+int16_t filterEma(EMA *ema, int16_t x)
+{
+    ema->acc += x - (ema->acc >> ema->log2Tau);
+    return ema->acc >> ema->log2Tau;
+}
+
+int16_t getEma(const EMA *ema)
+{
+    return ema->acc >> ema->log2Tau;
+}
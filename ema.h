@@ -0,0 +1,40 @@
+// Exponential Moving Average Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef EMA_H_
+#define EMA_H_
+
+#include <stdint.h>
+
+// First order IIR y += (x - y) / 2^log2Tau, time constant 2^log2Tau samples
+#define EMA_MAX_LOG2_TAU 15
+
+typedef struct _EMA
+{
+    int32_t acc;                                     // y * 2^log2Tau
+    uint8_t log2Tau;
+} EMA;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint8_t getEmaLog2Tau(uint32_t timeConstantMs, uint32_t sampleRateHz);
+void initEma(EMA *ema, uint8_t log2Tau, int16_t y);
+int16_t filterEma(EMA *ema, int16_t x);
+int16_t getEma(const EMA *ema);
+
+#endif
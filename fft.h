@@ -0,0 +1,34 @@
+// FFT Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FFT_H_
+#define FFT_H_
+
+#include <stdint.h>
+
+// Largest transform supported by the twiddle table
+#define FFT_MAX_LOG2_N 10
+#define FFT_MAX_N      (1 << FFT_MAX_LOG2_N)
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int16_t sinQ15(uint16_t phase);
+int16_t cosQ15(uint16_t phase);
+void fftQ31(int32_t *re, int32_t *im, uint8_t log2N);
+
+#endif
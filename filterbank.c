@@ -0,0 +1,182 @@
+// Filter Bank Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "filterbank.h"
+
+#define Q30_ONE      (1 << 30)
+#define Q30_PI       3373259426LL
+#define Q30_HALF_PI  1686629713LL
+#define Q30_SQRT1_2  759250125LL                     // 1/sqrt(2), alpha = sin(w) / 2Q
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// sin and cos in Q30 of w (radians, Q30, 0 <= w <= pi) by Taylor series
+// about 0 after folding w into 0..pi/2, accurate to about 1e-8
+void getSinCosQ30(int64_t w, int64_t *s, int64_t *c)
+{
+    bool fold = w > Q30_HALF_PI;
+    int64_t w2, t;
+    uint8_t k;
+
+    if (fold)
+        w = Q30_PI - w;
+    w2 = (w * w) >> 30;
+
+    //sin w = w (1 - w^2/(2*3) (1 - w^2/(4*5) (1 - ...)))
+    t = Q30_ONE;
+    for (k = 13; k > 1; k -= 2)
+        t = Q30_ONE - ((w2 * t) >> 30) / (k * (k - 1));
+    *s = (w * t) >> 30;
+
+    //cos w = 1 - w^2/(1*2) (1 - w^2/(3*4) (1 - ...))
+    t = Q30_ONE;
+    for (k = 14; k > 0; k -= 2)
+        t = Q30_ONE - ((w2 * t) >> 30) / (k * (k - 1));
+    *c = fold ? -t : t;
+}
+
+// Butterworth (Q = 1/sqrt(2)) high-pass or low-pass at cornerHz, from the
+// bilinear-transform (audio EQ cookbook) prototypes
+void setButterworthBiquad(BIQUAD *bq, uint32_t cornerHz, uint32_t sampleRateHz, bool highPass)
+{
+    int64_t w = (2 * Q30_PI * cornerHz) / sampleRateHz;
+    int64_t s, c, alpha, a0, b0, b1;
+
+    getSinCosQ30(w, &s, &c);
+    alpha = (s * Q30_SQRT1_2) >> 30;
+    a0 = Q30_ONE + alpha;
+    if (highPass)
+    {
+        b0 = (Q30_ONE + c) / 2;
+        b1 = -(Q30_ONE + c);
+    }
+    else
+    {
+        b0 = (Q30_ONE - c) / 2;
+        b1 = Q30_ONE - c;
+    }
+    bq->b0 = (b0 << 30) / a0;
+    bq->b1 = (b1 << 30) / a0;
+    bq->b2 = bq->b0;
+    bq->a1 = ((-2 * c) << 30) / a0;
+    bq->a2 = ((Q30_ONE - alpha) << 30) / a0;
+}
+
+// Set the DC blocker time constant (2^dcShift samples, dcShift 8 to 16),
+// no biquads, and clear all history
+void initFilterBank(FILTER_BANK *fb, uint8_t dcShift)
+{
+    uint8_t ch, i;
+    if (dcShift < FILTER_MIN_DC_SHIFT)
+        dcShift = FILTER_MIN_DC_SHIFT;
+    if (dcShift > FILTER_MAX_DC_SHIFT)
+        dcShift = FILTER_MAX_DC_SHIFT;
+    fb->stages = 0;
+    fb->dcShift = dcShift;
+    fb->primed = false;
+    for (ch = 0; ch < FILTER_CHANNELS; ch++)
+    {
+        fb->dc[ch] = 0;
+        for (i = 0; i < FILTER_MAX_STAGES; i++)
+            fb->state[ch][i].x1 = fb->state[ch][i].x2 = fb->state[ch][i].y1 = fb->state[ch][i].y2 = 0;
+    }
+}
+
+// Pass band lowHz to highHz; 0 for either corner leaves that side open
+// Biquad history is cleared, the DC estimates are kept
+// Returns false if a corner is not below the Nyquist frequency or the
+// corners are out of order
+bool setFilterBankBand(FILTER_BANK *fb, uint32_t lowHz, uint32_t highHz, uint32_t sampleRateHz)
+{
+    uint8_t ch, i;
+
+    if (lowHz >= sampleRateHz / 2 || highHz >= sampleRateHz / 2
+        || (highHz != 0 && lowHz >= highHz))
+        return false;
+    fb->stages = 0;
+    if (lowHz != 0)
+        setButterworthBiquad(&fb->stage[fb->stages++], lowHz, sampleRateHz, true);
+    if (highHz != 0)
+        setButterworthBiquad(&fb->stage[fb->stages++], highHz, sampleRateHz, false);
+    for (ch = 0; ch < FILTER_CHANNELS; ch++)
+        for (i = 0; i < FILTER_MAX_STAGES; i++)
+            fb->state[ch][i].x1 = fb->state[ch][i].x2 = fb->state[ch][i].y1 = fb->state[ch][i].y2 = 0;
+    return true;
+}
+
+// Filter count interleaved frames in place (frames[n * FILTER_CHANNELS + ch])
+// The DC blocker subtracts a running mean (seeded with the first frame so
+// the bias does not ring through); the sections then run in Q8 with 64-bit
+// accumulation, and the output saturates to 16 bits
+void filterFilterBank(FILTER_BANK *fb, int16_t *frames, uint16_t count)
+{
+    BIQUAD *bq;
+    BIQUAD_STATE *st;
+    int64_t acc;
+    int32_t x, y;
+    uint16_t n;
+    uint8_t ch, i;
+
+    if (!fb->primed && count > 0)
+    {
+        for (ch = 0; ch < FILTER_CHANNELS; ch++)
+            fb->dc[ch] = (int32_t)frames[ch] << fb->dcShift;
+        fb->primed = true;
+    }
+
+    for (ch = 0; ch < FILTER_CHANNELS; ch++)
+    {
+        for (n = 0; n < count; n++)
+        {
+            x = frames[n * FILTER_CHANNELS + ch];
+            fb->dc[ch] += x - (fb->dc[ch] >> fb->dcShift);
+            x = (x << 8) - (fb->dc[ch] >> (fb->dcShift - 8));
+            for (i = 0; i < fb->stages; i++)
+            {
+                bq = &fb->stage[i];
+                st = &fb->state[ch][i];
+                acc = (int64_t)bq->b0 * x + (int64_t)bq->b1 * st->x1 + (int64_t)bq->b2 * st->x2
+                    - (int64_t)bq->a1 * st->y1 - (int64_t)bq->a2 * st->y2;
+                y = (acc + (1 << 29)) >> 30;
+                if (y > (32767 << 8))
+                    y = 32767 << 8;
+                else if (y < -(32768 << 8))
+                    y = -(32768 << 8);
+                st->x2 = st->x1;
+                st->x1 = x;
+                st->y2 = st->y1;
+                st->y1 = y;
+                x = y;
+            }
+            x = (x + (1 << 7)) >> 8;
+            if (x > 32767)
+                x = 32767;
+            else if (x < -32768)
+                x = -32768;
+            frames[n * FILTER_CHANNELS + ch] = x;
+        }
+    }
+}
+
+// Current DC estimate of a channel (the mic bias, in input counts)
+int16_t getFilterBankDc(const FILTER_BANK *fb, uint8_t ch)
+{
+    return fb->dc[ch] >> fb->dcShift;
+}
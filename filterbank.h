@@ -0,0 +1,66 @@
+// Filter Bank Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FILTERBANK_H_
+#define FILTERBANK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// DC blocker followed by a cascade of biquads (a Butterworth high-pass at
+// the low corner and low-pass at the high corner), run on interleaved
+// frames of FILTER_CHANNELS samples
+#define FILTER_CHANNELS   3
+#define FILTER_MAX_STAGES 2
+// The DC estimate is kept in 32 bits, so full-scale 16-bit input (the Q3
+// decimator output) allows up to 2^15 samples
+#define FILTER_MIN_DC_SHIFT 8
+#define FILTER_MAX_DC_SHIFT 15
+
+// Direct form I section, coefficients in Q30 (a0 normalized to 1)
+typedef struct _BIQUAD
+{
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+} BIQUAD;
+
+// Section history in Q8 (sample units with 8 fraction bits)
+typedef struct _BIQUAD_STATE
+{
+    int32_t x1, x2;
+    int32_t y1, y2;
+} BIQUAD_STATE;
+
+typedef struct _FILTER_BANK
+{
+    BIQUAD stage[FILTER_MAX_STAGES];
+    uint8_t stages;
+    uint8_t dcShift;                                 // DC estimate time constant 2^dcShift samples
+    bool primed;
+    int32_t dc[FILTER_CHANNELS];                     // DC estimate * 2^dcShift
+    BIQUAD_STATE state[FILTER_CHANNELS][FILTER_MAX_STAGES];
+} FILTER_BANK;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initFilterBank(FILTER_BANK *fb, uint8_t dcShift);
+bool setFilterBankBand(FILTER_BANK *fb, uint32_t lowHz, uint32_t highHz, uint32_t sampleRateHz);
+void filterFilterBank(FILTER_BANK *fb, int16_t *frames, uint16_t count);
+int16_t getFilterBankDc(const FILTER_BANK *fb, uint8_t ch);
+
+#endif
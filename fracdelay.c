@@ -0,0 +1,90 @@
+// Fractional Delay Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "fracdelay.h"
+
+#define Q15_ONE 32768
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Convert a delay in ns to a fraction of the sample period in Q15
+// Delays of a full period or more are limited to just under one sample
+uint16_t getFracDelayMu(uint32_t delayNs, uint32_t sampleRateHz)
+{
+    uint64_t mu = ((uint64_t)delayNs * sampleRateHz * Q15_ONE + 500000000) / 1000000000;
+    if (mu >= Q15_ONE)
+        mu = Q15_ONE - 1;
+    return mu;
+}
+
+// Set the taps for a delay of 1 + mu samples (mu in Q15, 0 <= mu < 1)
+// h0 = -mu(mu-1)(mu-2)/6, h1 = (mu+1)(mu-1)(mu-2)/2,
+// h2 = -(mu+1)mu(mu-2)/2, h3 = (mu+1)mu(mu-1)/6
+void initFracDelay(FRAC_DELAY *fd, uint16_t mu)
+{
+    int64_t m = mu;
+    int64_t a = m - Q15_ONE;                         // mu - 1
+    int64_t b = m - 2 * Q15_ONE;                     // mu - 2
+    int64_t c = m + Q15_ONE;                         // mu + 1
+    uint8_t i;
+
+    fd->coeff[0] = -(m * a * b) / (6LL << 30);
+    fd->coeff[1] =  (c * a * b) / (2LL << 30);
+    fd->coeff[2] = -(c * m * b) / (2LL << 30);
+    fd->coeff[3] =  (c * m * a) / (6LL << 30);
+
+    for (i = 0; i < FRAC_DELAY_TAPS - 1; i++)
+        fd->hist[i] = 0;
+}
+
+// Set count delays so that streams sampled skewNs[i] after a common instant
+// come out lined up: a stream sampled later is held back longer, by its
+// skew beyond the earliest one, so every output refers to the earliest
+// instant one sample back
+void alignFracDelays(FRAC_DELAY fd[], const uint32_t skewNs[], uint8_t count,
+                     uint32_t sampleRateHz)
+{
+    uint32_t earliest = UINT32_MAX;
+    uint8_t i;
+    for (i = 0; i < count; i++)
+        if (skewNs[i] < earliest)
+            earliest = skewNs[i];
+    for (i = 0; i < count; i++)
+        initFracDelay(&fd[i], getFracDelayMu(skewNs[i] - earliest, sampleRateHz));
+}
+
+// Filter one sample, returning the input delayed by 1 + mu samples
+int16_t filterFracDelay(FRAC_DELAY *fd, int16_t x)
+{
+    int32_t acc = fd->coeff[0] * x
+                + fd->coeff[1] * fd->hist[0]
+                + fd->coeff[2] * fd->hist[1]
+                + fd->coeff[3] * fd->hist[2];
+
+    fd->hist[2] = fd->hist[1];
+    fd->hist[1] = fd->hist[0];
+    fd->hist[0] = x;
+
+    acc = (acc + (1 << 14)) >> 15;
+    if (acc > 32767)
+        acc = 32767;
+    else if (acc < -32768)
+        acc = -32768;
+    return acc;
+}
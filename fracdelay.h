@@ -0,0 +1,41 @@
+// Fractional Delay Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef FRACDELAY_H_
+#define FRACDELAY_H_
+
+#include <stdint.h>
+
+// Cubic Lagrange (Farrow) interpolator, delay is 1 + mu samples
+#define FRAC_DELAY_TAPS 4
+
+typedef struct _FRAC_DELAY
+{
+    int32_t coeff[FRAC_DELAY_TAPS];                  // Q15
+    int16_t hist[FRAC_DELAY_TAPS - 1];               // x[n-1], x[n-2], x[n-3]
+} FRAC_DELAY;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint16_t getFracDelayMu(uint32_t delayNs, uint32_t sampleRateHz);
+void initFracDelay(FRAC_DELAY *fd, uint16_t mu);
+void alignFracDelays(FRAC_DELAY fd[], const uint32_t skewNs[], uint8_t count,
+                     uint32_t sampleRateHz);
+int16_t filterFracDelay(FRAC_DELAY *fd, int16_t x);
+
+#endif
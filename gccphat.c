@@ -0,0 +1,140 @@
+// GCC-PHAT Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "fft.h"
+#include "tdoa.h"
+#include "gccphat.h"
+
+#if GCC_PHAT_LOG2_N < 8 || GCC_PHAT_LOG2_N > FFT_MAX_LOG2_N
+#error "GCC_PHAT_LOG2_N must be 8 to 10"
+#endif
+
+// Input samples are scaled up by this shift before the FFT (Q3 samples of
+// 12-bit data then span about +/-2^27, inside the +/-2^30 the FFT accepts)
+#define INPUT_SHIFT 13
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+int32_t phatRe[GCC_PHAT_N];
+int32_t phatIm[GCC_PHAT_N];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Scale (re, im) to unit magnitude in Q24; the magnitude is estimated as
+// max + 3/8 min, which is within 7% and never below the larger component,
+// and only the phase matters for PHAT
+void whiten(int64_t *re, int64_t *im)
+{
+    uint64_t ar = *re < 0 ? -*re : *re;
+    uint64_t ai = *im < 0 ? -*im : *im;
+    uint64_t mag = ar > ai ? ar + (ai * 3 >> 3) : ai + (ar * 3 >> 3);
+    uint8_t shift = 0;
+    int32_t m;
+
+    if (mag == 0)
+        return;
+    while ((mag >> shift) >= (1 << 16))
+        shift++;
+    m = mag >> shift;
+    if (m < (1 << 15))
+        m = 1 << 15;                                 // tiny bins stay tiny
+    *re = ((*re >> shift) << 15) / m;                // Q15, |re| <= 1
+    *im = ((*im >> shift) << 15) / m;
+    *re <<= 9;                                       // Q24
+    *im <<= 9;
+}
+
+// Generalized cross-correlation with phase transform over GCC_PHAT_N
+// samples taken from rings (sample k is a[(start + k) & mask])
+// Both mean-removed, Hann-windowed inputs share one complex FFT (a + jb)
+// and are separated by conjugate symmetry; the whitened cross-spectrum is
+// transformed back and the peak picked within +/-maxLag
+// Returns the lag of the peak; positive means b hears the sound after a
+// If lagQ8 is not null, it receives the peak lag refined to 1/256 sample
+int16_t findGccPhatLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t mask,
+                       int16_t maxLag, int32_t *lagQ8)
+{
+    int32_t sumA = 0, sumB = 0;
+    int16_t meanA, meanB;
+    int32_t w;
+    int64_t ar, ai, br, bi, pr, pi;
+    int32_t best;
+    int16_t bestLag = 0;
+    int16_t d;
+    uint16_t k, j;
+
+    for (k = 0; k < GCC_PHAT_N; k++)
+    {
+        sumA += a[(start + k) & mask];
+        sumB += b[(start + k) & mask];
+    }
+    meanA = sumA >> GCC_PHAT_LOG2_N;
+    meanB = sumB >> GCC_PHAT_LOG2_N;
+
+    // Hann window w = (1 - cos(2*pi*k/N)) / 2 in Q15
+    for (k = 0; k < GCC_PHAT_N; k++)
+    {
+        w = (32768 - cosQ15(k << (FFT_MAX_LOG2_N - GCC_PHAT_LOG2_N))) >> 1;
+        phatRe[k] = ((int64_t)(a[(start + k) & mask] - meanA) * w) >> (15 - INPUT_SHIFT);
+        phatIm[k] = ((int64_t)(b[(start + k) & mask] - meanB) * w) >> (15 - INPUT_SHIFT);
+    }
+
+    fftQ31(phatRe, phatIm, GCC_PHAT_LOG2_N);
+
+    // A = (Z[k] + conj(Z[N-k])) / 2, B = (Z[k] - conj(Z[N-k])) / 2j,
+    // P = conj(A) B whitened; bin N-k gets conj(P), and the whole spectrum
+    // is conjugated so the forward FFT below acts as the inverse
+    for (k = 0; k <= GCC_PHAT_N / 2; k++)
+    {
+        j = (GCC_PHAT_N - k) & (GCC_PHAT_N - 1);
+        ar = (phatRe[k] + (int64_t)phatRe[j]) >> 1;
+        ai = (phatIm[k] - (int64_t)phatIm[j]) >> 1;
+        br = (phatIm[k] + (int64_t)phatIm[j]) >> 1;
+        bi = (phatRe[j] - (int64_t)phatRe[k]) >> 1;
+        pr = ar * br + ai * bi;
+        pi = ar * bi - ai * br;
+        whiten(&pr, &pi);
+        phatRe[k] = pr;
+        phatIm[k] = -pi;
+        phatRe[j] = pr;
+        phatIm[j] = pi;
+    }
+
+    fftQ31(phatRe, phatIm, GCC_PHAT_LOG2_N);
+
+    // Real part of the inverse holds the correlation, lag d at index d mod N
+    best = phatRe[0];
+    for (d = -maxLag; d <= maxLag; d++)
+    {
+        k = d & (GCC_PHAT_N - 1);
+        if (phatRe[k] > best)
+        {
+            best = phatRe[k];
+            bestLag = d;
+        }
+    }
+
+    if (lagQ8)
+        *lagQ8 = ((int32_t)bestLag << 8)
+               + interpolateTdoaPeak(phatRe[(bestLag - 1) & (GCC_PHAT_N - 1)], best,
+                                     phatRe[(bestLag + 1) & (GCC_PHAT_N - 1)]);
+    return bestLag;
+}
@@ -0,0 +1,33 @@
+// GCC-PHAT Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef GCCPHAT_H_
+#define GCCPHAT_H_
+
+#include <stdint.h>
+
+// Transform length 256 (8) to 1024 (10); the work buffers use 2 * 4 * N bytes
+#define GCC_PHAT_LOG2_N 9
+#define GCC_PHAT_N      (1 << GCC_PHAT_LOG2_N)
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int16_t findGccPhatLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t mask,
+                       int16_t maxLag, int32_t *lagQ8);
+
+#endif
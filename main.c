@@ -25,11 +25,28 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "tm4c123gh6pm.h"
 #include "clock.h"
 #include "gpio.h"
 #include "adc0.h"
+#include "adc1.h"
+#include "timer1.h"
+#include "fracdelay.h"
+#include "decimate.h"
+#include "capture.h"
+#include "tdoa.h"
+#include "gccphat.h"
+#include "onset.h"
+#include "ema.h"
+#include "aoa.h"
+#include "filterbank.h"
+#include "spl.h"
+#include "noisefloor.h"
+#include "stalta.h"
+#include "slidecorr.h"
+#include "cycles.h"
 #include "uart0.h"
 #include "nvic.h"
 #include "wait.h"
@@ -46,33 +63,219 @@
 
 #define SS1_VECTOR 31
 
-//size of circular buffer for avg
-#define N 5
+//output sample rate per mic; the SS1 sequence rate (one conversion of all
+//three mics per timer tick) is this times the oversampling factor
+//20 kHz: one lag step is 50 us (17 mm of path), so the 100 mm layout spans
+//+/-6 whole lags for the onset table and the sliding correlators (both hold
+//8), the 4 kHz band edge sits well below Nyquist, and a block of 64 frames
+//leaves 2000 cycles per frame at 40 MHz (see the ISR load in "sampling")
+//4 steps per sequence at 1 Msps allow oversampling by up to 8
+#define SAMPLE_RATE 20000
+#define MAX_OVERSAMPLE_LOG2 3
+
+//ADC0 SS1 converts MIC1 then MIC3, ADC1 SS1 converts MIC2 alongside MIC1
+//(results per sequence that reach the FIFO)
+#define ADC0_STEPS 2
+#define ADC1_STEPS 1
+
+//ADC0 then converts MIC1 and MIC3 again for digital comparators 0 and 1
+#define ADC0_DC_STEPS 2
+
+//blocks without activity (about 100 ms) before per-sample processing stops
+//until the next comparator event
+#define QUIET_BLOCKS 32
+
+//samples from the decimators on are ADC counts in Q3 (CIC_FRAC_BITS), and
+//so are the filter bank, capture, floors, triggers and onset levels; only
+//the comparators (raw 12-bit counts) and the shell (counts) convert
+
+//noise floor trackers: |x| envelope over 2^6 samples, floor following it
+//down over 2^9 and up over 2^14 samples (about 0.8 s at 20 kHz); the
+//trigger sits a margin above the floor, never below MIN_TRIGGER counts,
+//and starts at 200 counts until the floors settle
+#define NOISE_ENV_SHIFT 6
+#define NOISE_FALL_SHIFT 9
+#define NOISE_RISE_SHIFT 14
+#define START_FLOOR (20 * CIC_ONE)
+#define MIN_TRIGGER (8 * CIC_ONE)
+
+//largest STA/LTA ratio setting (tenths) whose Q8 value fits 16 bits
+#define STA_MAX_RATIO10 (0xFFFF * 10 / STALTA_RATIO_Q8)
+
+//sequences per uDMA block
+#define BLOCK_SEQS 64
+
+//longest wait (cycles, 25 us at 40 MHz) for the ADC1 block matching an
+//ADC0 block; a few conversions even at 125 ksps
+#define ADC1_WAIT_CYCLES 1000
+
+//SPL averaging over 2^5 blocks (about 100 ms at 20 kHz) and the dB SPL of
+//1 count RMS before calibration: 3.3 V / 4096 per count (-61.9 dBV), a
+//-44 dBV/Pa mic and a 40 dB preamp give 94 - 61.9 + 44 - 40 = 36.1 dB;
+//the meter sees Q3 samples, so its offset is 6.02 dB per fraction bit less
+#define SPL_LOG2_BLOCKS 5
+#define SPL_COUNT_OFFSET_Q8 9242
+#define SPL_Q3_DB_Q8 (CIC_FRAC_BITS * 1541)
+#define SPL_OFFSET_Q8 (SPL_COUNT_OFFSET_Q8 - SPL_Q3_DB_Q8)
+
+//mic bias removal time constant (2^11 samples, about 100 ms at 20 kHz)
+#define DC_SHIFT 11
+
+//distance between each pair of mics in the default equilateral layout:
+//MIC1 at the apex and the centroid at the origin
+#define MIC_SPACING_MM 100
+#define MIC_DEFAULT_X_MM {0, -50, 50}
+#define MIC_DEFAULT_Y_MM {58, -29, -29}
+
+//mic positions set from the shell are limited to +/- this (mm)
+#define MIC_MAX_MM 1000
+
+//direction solutions with a larger residual (1/256 sample) are failures
+#define FAIL_RESIDUAL 64
+
+//TDOA engines selectable from the shell
+#define TDOA_XCORR 0
+#define TDOA_PHAT 1
+#define TDOA_ONSET 2
+#define TDOA_SIGN 3
+#define TDOA_SEEDED 4
+#define TDOA_SLIDE 5
+
+//the seeded engine refines the sign correlation lag over +/- this many samples
+#define SIGN_SEED_RADIUS 2
+
+//onset detector backoff decays by 1/2048 per sample (about 100 ms at 20 kHz)
+#define ONSET_DECAY_SHIFT 11
 
 //checking to make sure interrupt functions correctly
 int counter = 0;
-uint8_t avg_phase = 0;
 
-//raw values coming in from read adc function
+//filtered samples (Q3) of the first threshold crossing since the main loop
+//last showed one; the ISR leaves them alone while raw_pending is set
 int mic1_raw = 0;
 int mic2_raw = 0;
 int mic3_raw = 0;
-
-//circular buffer variables for each mic
-uint8_t index1 = 0, index2 = 0, index3 = 0;
-uint32_t sum1 = 0, sum2 = 0, sum3 = 0;
-uint32_t mic1_avg = 0, mic2_avg = 0, mic3_avg = 0;
-uint32_t avg_arr1[N] = {0};
-uint32_t avg_arr2[N] = {0};
-uint32_t avg_arr3[N] = {0};
-
-uint32_t time_delay_arr[2];
-
+bool raw_pending = false;
+
+//running average of each mic (Q3), time constant set by tc (ms)
+EMA mic_ema[3];
+int32_t mic1_avg = 0, mic2_avg = 0, mic3_avg = 0;
+
+//signed delays for mic pairs 1-2, 1-3, 2-3 (positive: second mic hears it later)
+//in 1/256 sample, refined between samples by peak interpolation
+int32_t time_delay_arr[3];
+int32_t time_delay_us[3];
+uint32_t tdoa_cycles = 0;
+uint8_t tdoa_engine = TDOA_XCORR;
+const char *tdoa_engine_name[] = {"xcorr", "phat", "onset", "sign", "seeded", "slide"};
+
+//per-mic threshold onsets and the lags of the first complete onset group
+//inside the held capture window (kept until that window is processed)
+ONSET_DETECTOR mic_onset[3];
+ONSET_GROUP onset_group;
+int16_t onset_lag[3];
+uint32_t onset_window = 0;
+bool onset_ready = false;
+
+//uDMA ping-pong sample blocks
+int16_t adc0_ping[BLOCK_SEQS * ADC0_STEPS];
+int16_t adc0_pong[BLOCK_SEQS * ADC0_STEPS];
+int16_t adc1_ping[BLOCK_SEQS * ADC1_STEPS];
+int16_t adc1_pong[BLOCK_SEQS * ADC1_STEPS];
+
+//AIN inputs for each converter, in step order
+const uint8_t adc0_ain[ADC0_STEPS + ADC0_DC_STEPS] = {1, 4, 1, 4};
+const uint8_t adc1_ain[ADC1_STEPS] = {2};
+
+//sampling instant of each mic relative to the trigger (ns)
+uint32_t mic_skew_ns[3] = {0};
+
+//fractional delays that line every mic up with the earliest sampling instant
+FRAC_DELAY mic_align[3];
+
+//converter rate and oversample-then-decimate factor (log2, 0 = off)
+uint32_t conversion_rate = 1000000;
+uint8_t oversample_log2 = 0;
+CIC_DECIMATOR mic_cic[3];
+
+//bias removal and band-pass ahead of detection and correlation (Hz, 0 = open)
+FILTER_BANK mic_filter;
+uint32_t band_low_hz = 100;
+uint32_t band_high_hz = 4000;
+
+//running level of each mic
+SPL_METER mic_spl;
+
+//background level of each mic, trigger margin above it (dB) and the
+//resulting activity thresholds (Q3 counts from the filtered zero level)
+NOISE_FLOOR mic_noise[3];
+uint8_t margin_db = 20;
+uint16_t mic_trigger[3];
+
+//STA/LTA energy-ratio detectors (windows in samples, ratios in tenths) and
+//the span of the last event across all mics (capture sample indices)
+STA_LTA mic_stalta[3];
+uint16_t sta_len = 32;
+uint16_t lta_len = 1024;
+uint16_t sta_on10 = 40;
+uint16_t sta_off10 = 15;
+uint32_t stalta_start = 0;
+uint32_t stalta_end = 0;
+bool stalta_active = false;
+bool stalta_ready = false;
+
+//sliding correlators of the three pairs (updated per sample only while the
+//slide engine is selected), their vectors as the last capture window
+//completed, and the cycles taken by one sample's update
+//slide_valid is false while the mics are too far apart for SLIDE_MAX_LAG
+SLIDE_CORR pair_corr[3];
+int64_t slide_vector[3][2 * SLIDE_MAX_LAG + 1];
+int16_t slide_lag = 0;
+bool slide_valid = false;
+bool slide_ready = false;
+uint32_t slide_cycles = 0;
+
+//levels last written to the MIC1/MIC3 comparators (raw counts)
+uint16_t comparator_high[2];
+uint16_t comparator_low[2];
+
+//mic positions (mm), MIC1 to MIC3; the onset lookup table is only built
+//for the default layout, so it is valid while the mics are there
+int16_t mic_x_mm[3] = MIC_DEFAULT_X_MM;
+int16_t mic_y_mm[3] = MIC_DEFAULT_Y_MM;
+bool aoa_table_valid = false;
+
+//angle of arrival in degrees Q8 (0 to 360), least-squares residual
+//(1/256 sample) and cycles taken by the solver
 uint32_t aoa_val = 0;
+uint32_t aoa_residual = 0;
+bool aoa_fail = false;
+uint32_t aoa_cycles = 0;
+
+//set by a comparator event, cleared after QUIET_BLOCKS with no activity
+bool processing = false;
+bool activity = false;
+uint16_t quiet_blocks = 0;
+
+//sequence count (acquisition timestamp), index of the last lost sample,
+//and flag telling the localization code that the current event has gaps
+uint32_t seq_count = 0;
+uint32_t last_loss_seq = 0;
+uint32_t loss_events = 0;
+uint32_t dma_stalls = 0;
+bool data_invalid = false;
+
+//ADC0 blocks dropped because the matching ADC1 block never came, and ADC1
+//blocks still to be dropped when they arrive so the pairs line up again
+uint32_t adc1_timeouts = 0;
+uint16_t adc1_owed = 0;
+
+//most cycles the ISR spent on one block since "sampling" last showed it
+uint32_t block_cycles = 0;
 
 //UI variables
 USER_DATA data;
-uint32_t time_constant = 0;
+uint32_t time_constant = 1;
 uint32_t backoff_val = 0;
 uint32_t holdoff_val = 0;
 uint32_t hysteresis_val = 0;
@@ -84,7 +287,131 @@ bool displayFail = false;
 //-----------------------------------------------------------------------------
 
 
-void readIsr()
+// Attach the STA/LTA detectors to the capture rings with the current
+// windows and ratios; returns false if they are out of range
+bool setStaLta()
+{
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+        if (!initStaLta(&mic_stalta[i], getCaptureRing(i), CAPTURE_MASK, getCaptureCount(),
+                        sta_len, lta_len, sta_on10 * STALTA_RATIO_Q8 / 10,
+                        sta_off10 * STALTA_RATIO_Q8 / 10))
+            return false;
+    stalta_active = false;
+    stalta_ready = false;
+    return true;
+}
+
+// Track the event span: it starts when the first mic triggers and ends
+// when the last one de-triggers
+void detectStaLta(uint32_t time)
+{
+    bool any = false;
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+    {
+        updateStaLta(&mic_stalta[i], time);
+        any |= mic_stalta[i].active;
+    }
+    if (any && !stalta_active)
+    {
+        stalta_active = true;
+        stalta_ready = false;
+        stalta_start = time;
+    }
+    else if (!any && stalta_active)
+    {
+        stalta_active = false;
+        stalta_ready = true;
+        stalta_end = time;
+    }
+}
+
+// True while the mics are in the default MIC_SPACING_MM layout
+bool isDefaultMicLayout()
+{
+    static const int16_t x[3] = MIC_DEFAULT_X_MM;
+    static const int16_t y[3] = MIC_DEFAULT_Y_MM;
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+        if (mic_x_mm[i] != x[i] || mic_y_mm[i] != y[i])
+            return false;
+    return true;
+}
+
+// Attach the sliding correlators to the capture rings over one capture
+// window, with lags set by the mic geometry
+// Returns false (and leaves the correlators stopped) if the geometry needs
+// more than SLIDE_MAX_LAG lags, rather than missing the outer lags
+bool setSlideCorr()
+{
+    static const uint8_t pair[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    uint8_t i;
+    slide_lag = getMaxTdoaLag(getMaxMicSpacingMm(mic_x_mm, mic_y_mm), SAMPLE_RATE);
+    slide_ready = false;
+    slide_valid = slide_lag <= SLIDE_MAX_LAG;
+    for (i = 0; i < 3 && slide_valid; i++)
+        slide_valid = initSlideCorr(&pair_corr[i], getCaptureRing(pair[i][0]),
+                                    getCaptureRing(pair[i][1]), CAPTURE_MASK, getCaptureCount(),
+                                    CAPTURE_PRE + CAPTURE_POST, slide_lag);
+    return slide_valid;
+}
+
+// Slide the pair correlations on by one sample and keep their vectors when
+// the held capture window completes with it
+void updateSlideCorrs(uint32_t time)
+{
+    CAPTURE_WINDOW win;
+    uint32_t start = getCycleCount();
+    uint8_t i, k;
+    if (!slide_valid)
+        return;
+    for (i = 0; i < 3; i++)
+        updateSlideCorr(&pair_corr[i], time);
+    slide_cycles = getElapsedCycles(start);
+    if (getCaptureWindow(&win) && time + 1 - win.start == win.length)
+    {
+        for (i = 0; i < 3; i++)
+            for (k = 0; k <= 2 * slide_lag; k++)
+                slide_vector[i][k] = pair_corr[i].acc[k];
+        slide_ready = true;
+    }
+}
+
+// Timestamp threshold onsets of each mic; the first complete group of
+// onsets inside the held capture window gives the pairwise lags directly
+// Every detector sees every sample (their holdoff, backoff and re-arm
+// state depend on it) before any group is latched
+void detectOnsets(int16_t mic1, int16_t mic2, int16_t mic3)
+{
+    static const uint8_t pair[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    CAPTURE_WINDOW win;
+    int16_t x[3];
+    bool onset[3];
+    uint32_t time = getCaptureCount() - 1;
+    uint8_t i, j;
+
+    x[0] = mic1;
+    x[1] = mic2;
+    x[2] = mic3;
+    for (i = 0; i < 3; i++)
+        onset[i] = detectOnset(&mic_onset[i], x[i], time);
+    for (i = 0; i < 3; i++)
+    {
+        if (onset[i] && addOnset(&onset_group, i, time)
+            && !onset_ready && getCaptureHold(&win)
+            && onset_group.first - win.start < win.length && time - win.start < win.length)
+        {
+            onset_window = win.start;
+            for (j = 0; j < 3; j++)
+                onset_lag[j] = getOnsetLag(&onset_group, pair[j][0], pair[j][1]);
+            onset_ready = true;
+        }
+    }
+}
+
+// Per-sample processing of filtered samples (threshold check)
+void processSample(int16_t mic1, int16_t mic2, int16_t mic3)
 {
     if(counter == 333333)
     {
@@ -94,73 +421,443 @@ void readIsr()
 
     counter++;
 
+    if(abs(mic3) > mic_trigger[2] || abs(mic2) > mic_trigger[1] || abs(mic1) > mic_trigger[0])
+    {
+        activity = true;
+        triggerCapture();
+        if (!raw_pending)
+        {
+            mic1_raw = mic1;
+            mic2_raw = mic2;
+            mic3_raw = mic3;
+            raw_pending = true;
+        }
+    }
+}
+
+// Show the threshold crossing kept by processSample() (main loop only, so
+// the ISR never waits on the UART)
+void printRaw()
+{
     char str[80];
+    snprintf(str, sizeof(str), "mic1 raw: %d mic2 raw: %d  mic3 raw: %d\n\n", mic1_raw >> CIC_FRAC_BITS,
+             mic2_raw >> CIC_FRAC_BITS, mic3_raw >> CIC_FRAC_BITS);
+    putsUart0(str);
+    raw_pending = false;
+}
 
-    //read and store adc values
-//    mic1_raw = readAdc0Ss1();
-//    mic2_raw = readAdc0Ss1();
-//    mic3_raw = readAdc0Ss1();
-    mic3_raw = readAdc0Ss1();
-    mic1_raw = readAdc0Ss1();
-    mic2_raw = readAdc0Ss1();
+// Running averages of the unfiltered samples (mic bias included), kept on
+// every frame so they are settled when an event starts
+void updateAverages(int16_t mic1, int16_t mic2, int16_t mic3)
+{
+    mic1_avg = filterEma(&mic_ema[0], mic1);
+    mic2_avg = filterEma(&mic_ema[1], mic2);
+    mic3_avg = filterEma(&mic_ema[2], mic3);
+}
+
+// Set the converter rate and the oversampling factor (2^log2Factor sequences
+// are decimated to each output sample), then re-derive the mic skew
+// Call with the timer stopped; returns false if the converters cannot
+// finish a sequence within one timer period
+bool setSampling(uint32_t sps, uint8_t log2Factor)
+{
+    uint8_t i;
+    if (log2Factor > MAX_OVERSAMPLE_LOG2)
+        return false;
+    if ((uint64_t)(ADC0_STEPS + ADC0_DC_STEPS) * (SAMPLE_RATE << log2Factor) > sps)
+        return false;
+    if (!setAdc0ConversionRate(sps))
+        return false;
+    setAdc1ConversionRate(sps);
+    setAdc0Ss1Rate(SAMPLE_RATE << log2Factor);
+
+    for (i = 0; i < 3; i++)
+        initCicDecimator(&mic_cic[i], log2Factor);
+
+    //MIC1 and MIC2 convert together, MIC3 one step later on ADC0, so MIC3
+    //is held back by that step to line up with the other two
+    mic_skew_ns[0] = 0;
+    mic_skew_ns[1] = 0;
+    mic_skew_ns[2] = getAdc0Ss1StepNs();
+    alignFracDelays(mic_align, mic_skew_ns, 3, SAMPLE_RATE);
+
+    conversion_rate = sps;
+    oversample_log2 = log2Factor;
+    return true;
+}
+
+// Raw counts, as the shell sets them, in the Q3 of the sample pipeline
+// (limited to the converter range)
+uint16_t getQ3Counts(uint32_t counts)
+{
+    return (counts < 4096 ? counts : 4095) << CIC_FRAC_BITS;
+}
 
-    if(mic3_raw > 200 || mic2_raw > 200 || mic1_raw > 200)
+// Q3 counts in tenths of a count, for display
+int32_t getCountsX10(int32_t q3)
+{
+    return (q3 * 10 + CIC_ONE / 2) >> CIC_FRAC_BITS;
+}
+
+// Program the MIC1/MIC3 comparators to the trigger level above each mic's
+// bias, with the hysteresis below it; a comparator is only rewritten when
+// its levels change, since writing it re-arms it
+// The comparators see raw 12-bit results, so the Q3 levels are rounded
+// MIC2 is not watched: its converter's vector also carries ADC1 uDMA done
+void setTriggerComparators()
+{
+    static const uint8_t comp_mic[2] = {0, 2};
+    int32_t high;
+    uint16_t low;
+    uint8_t c;
+    for (c = 0; c < 2; c++)
     {
-        snprintf(str, sizeof(str), "mic1 raw: %d mic2 raw: %d  mic3 raw: %d\n\n", mic1_raw, mic2_raw, mic3_raw);
-        putsUart0(str);
+        high = (getFilterBankDc(&mic_filter, comp_mic[c]) + mic_trigger[comp_mic[c]]
+                + CIC_ONE / 2) >> CIC_FRAC_BITS;
+        if (high > 4095)
+            high = 4095;
+        if (high < 0)
+            high = 0;
+        low = hysteresis_val < 4096 && high > (int32_t)hysteresis_val ? high - (int32_t)hysteresis_val : 0;
+        if (high != comparator_high[c] || low != comparator_low[c])
+        {
+            setAdc0Comparator(c, high, low);
+            comparator_high[c] = high;
+            comparator_low[c] = low;
+        }
     }
+}
 
-    //can split average calculation to be done every 4th time
-    //or split calculating avg for only ONE microphone each time
-    //this lessens load + amount of math needed per interrupt
-//    //mic1 circular buffer
-    if(avg_phase == 0)
+// Start every floor where the trigger sits at about 200 counts
+void initNoiseFloors()
+{
+    uint8_t i;
+    for (i = 0; i < 3; i++)
     {
-        sum1 -= avg_arr1[index1];  //oldest
-        sum1 += mic1_raw;     //newest
-        avg_arr1[index1] = mic1_raw;
-        index1 = (index1 + 1) % N;
-        mic1_avg = sum1 / N;
+        initNoiseFloor(&mic_noise[i], NOISE_ENV_SHIFT, NOISE_FALL_SHIFT, NOISE_RISE_SHIFT,
+                       START_FLOOR);
+        mic_trigger[i] = getNoiseThreshold(&mic_noise[i], margin_db, MIN_TRIGGER);
+    }
+    setTriggerComparators();
+}
 
-        avg_phase++;
+// Derive each mic's trigger from its noise floor and pass it to the onset
+// detectors; the comparators follow only between events so a running
+// event is not re-armed
+void updateTriggers()
+{
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+    {
+        mic_trigger[i] = getNoiseThreshold(&mic_noise[i], margin_db, MIN_TRIGGER);
+        setOnsetLevel(&mic_onset[i], mic_trigger[i]);
     }
+    if (!processing)
+        setTriggerComparators();
+}
 
-    snprintf(str, sizeof(str), "mic1 avg:    %d\n\n", mic1_avg);
+// Set the averaging time constant from tc, starting from the current averages
+void setAverages()
+{
+    uint8_t log2Tau = getEmaLog2Tau(time_constant, SAMPLE_RATE);
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+        initEma(&mic_ema[i], log2Tau, getEma(&mic_ema[i]));
+}
+
+// Program the onset detectors from the trigger level and the holdoff (ms),
+// backoff and hysteresis (raw counts) settings
+void setOnsetDetectors()
+{
+    uint8_t i;
+    for (i = 0; i < 3; i++)
+        initOnsetDetector(&mic_onset[i], mic_trigger[i], getQ3Counts(hysteresis_val),
+                          holdoff_val * SAMPLE_RATE / 1000, getQ3Counts(backoff_val),
+                          ONSET_DECAY_SHIFT);
+    initOnsetGroup(&onset_group, getMaxTdoaLag(getMaxMicSpacingMm(mic_x_mm, mic_y_mm),
+                                               SAMPLE_RATE));
+    onset_ready = false;
+}
+
+void printTdoa()
+{
+    char str[100];
+    snprintf(str, sizeof(str), "TDOA (1/256 sample) 1-2: %d (%d us)  1-3: %d (%d us)  2-3: %d (%d us)\n",
+             time_delay_arr[0], time_delay_us[0], time_delay_arr[1], time_delay_us[1],
+             time_delay_arr[2], time_delay_us[2]);
+    putsUart0(str);
+    snprintf(str, sizeof(str), "Engine (%s): %d cycles\n\n", tdoa_engine_name[tdoa_engine],
+             tdoa_cycles);
     putsUart0(str);
-//
-//    //mic2 circular buffer
-    if(avg_phase == 1)
+}
+
+void printAoa()
+{
+    char str[80];
+    snprintf(str, sizeof(str), "Current Angle of Arrival: %d.%d (theta)\n", aoa_val >> 8,
+             ((aoa_val & 0xFF) * 10) >> 8);
+    putsUart0(str);
+    snprintf(str, sizeof(str), "Residual: %d/256 sample%s  Solver: %d cycles\n\n", aoa_residual,
+             aoa_fail ? " (fail)" : "", aoa_cycles);
+    putsUart0(str);
+}
+
+// Localize one captured event (runs from the main loop, not the ISR)
+void processEvent(CAPTURE_WINDOW *win)
+{
+    static const uint8_t pair[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    char str[80];
+    bool invalid = data_invalid;
+    int16_t maxLag = getMaxTdoaLag(getMaxMicSpacingMm(mic_x_mm, mic_y_mm), SAMPLE_RATE);
+    int32_t lag[3];
+    int16_t seed;
+    uint32_t start;
+    uint8_t i;
+    uint16_t focus = win->trigger;
+    uint16_t first = 0;
+    uint16_t length = win->length;
+    int32_t from, to;
+    uint32_t staStart, staEnd;
+    bool staActive, staReady;
+
+    //take the STA/LTA span the ISR keeps as one consistent set
+    disableNvicInterrupt(SS1_VECTOR);
+    staStart = stalta_start;
+    staEnd = stalta_ready ? stalta_end : getCaptureCount();
+    staActive = stalta_active;
+    staReady = stalta_ready;
+    stalta_ready = false;
+    enableNvicInterrupt(SS1_VECTOR);
+
+    //narrow the correlation to the STA/LTA event (from one short window
+    //ahead of its trigger) when it starts inside the capture window
+    if (staActive || staReady)
+    {
+        from = staStart - sta_len - win->start;
+        to = staReady ? (int32_t)(staEnd - win->start) : win->length;
+        if (to > win->length)
+            to = win->length;
+        if (from >= 0 && from < win->length && to - from > 4 * maxLag)
+        {
+            focus = from;
+            first = from;
+            length = to - from;
+            snprintf(str, sizeof(str), "STA/LTA event: samples %d to %d\n", staStart, staEnd);
+            putsUart0(str);
+        }
+    }
+
+    //GCC-PHAT looks at one transform length starting a little before the event
+    uint32_t phatStart = win->start + focus - GCC_PHAT_N / 4;
+    if (focus < GCC_PHAT_N / 4)
+        phatStart = win->start;
+    else if (focus - GCC_PHAT_N / 4 + GCC_PHAT_N > win->length)
+        phatStart = win->start + win->length - GCC_PHAT_N;
+
+    //onset lags need a complete group inside this window; the window is
+    //complete, so the ISR has latched it already if there is one
+    if (tdoa_engine == TDOA_ONSET && !(onset_ready && onset_window == win->start))
+        invalid = true;
+
+    start = getCycleCount();
+    for (i = 0; i < 3; i++)
     {
-        sum2 -= avg_arr2[index2];  //oldest
-        sum2 += mic2_raw;     //newest
-        avg_arr2[index2] = mic2_raw;
-        index2 = (index2 + 1) % N;
-        mic2_avg = sum2 / N;
+        if (tdoa_engine == TDOA_ONSET)
+            lag[i] = (int32_t)onset_lag[i] << 8;
+        else if (tdoa_engine == TDOA_PHAT)
+            findGccPhatLag(getCaptureRing(pair[i][0]), getCaptureRing(pair[i][1]),
+                           phatStart, CAPTURE_MASK, maxLag, &lag[i]);
+        else if (tdoa_engine == TDOA_SLIDE)
+        {
+            //a geometry too wide for the correlators gives no lag at all
+            lag[i] = 0;
+            if (slide_valid)
+                getSlideCorrLag(slide_vector[i], slide_lag, &lag[i]);
+        }
+        else if (tdoa_engine == TDOA_SIGN || tdoa_engine == TDOA_SEEDED)
+        {
+            //a window too short for sign correlation gives no lag at all
+            lag[i] = 0;
+            if (!findSignTdoaLag(getCaptureRing(pair[i][0]), getCaptureRing(pair[i][1]),
+                                 win->start + first, length, CAPTURE_MASK, maxLag, &seed))
+                invalid = true;
+            else if (tdoa_engine == TDOA_SIGN)
+                lag[i] = (int32_t)seed << 8;
+            else
+                findTdoaLagNear(getCaptureRing(pair[i][0]), getCaptureRing(pair[i][1]),
+                                win->start + first, length, CAPTURE_MASK, maxLag, seed,
+                                SIGN_SEED_RADIUS, &lag[i]);
+        }
+        else
+            findTdoaLag(getCaptureRing(pair[i][0]), getCaptureRing(pair[i][1]),
+                        win->start + first, length, CAPTURE_MASK, maxLag, &lag[i]);
+    }
+    tdoa_cycles = getElapsedCycles(start);
+    onset_ready = false;
+
+    //sliding correlations need the vectors kept as this window completed
+    if (tdoa_engine == TDOA_SLIDE && (!slide_valid || !slide_ready))
+        invalid = true;
+    slide_ready = false;
+
+    //results only count if capture did not wrap into the window meanwhile
+    if (!releaseCapture())
+        invalid = true;
 
-        avg_phase++;
+    if (!invalid)
+    {
+        for (i = 0; i < 3; i++)
+        {
+            time_delay_arr[i] = lag[i];
+            time_delay_us[i] = getTdoaLagUs(lag[i], SAMPLE_RATE);
+        }
+        //whole-sample onset lags come straight from the table when the mics
+        //are where it was built for; others go through the least-squares
+        //solver over all three pairs
+        start = getCycleCount();
+        if (tdoa_engine == TDOA_ONSET && aoa_table_valid)
+        {
+            aoa_residual = 0;
+            aoa_fail = !lookupAoa(onset_lag[0], onset_lag[1], &aoa_val);
+        }
+        else
+            aoa_fail = !solveAoa(mic_x_mm, mic_y_mm, time_delay_arr, &aoa_val, &aoa_residual)
+                       || aoa_residual > FAIL_RESIDUAL;
+        aoa_cycles = getElapsedCycles(start);
     }
 
-    snprintf(str, sizeof(str), "mic2 avg:    %d\n\n", mic2_avg);
+    snprintf(str, sizeof(str), "Event at sample %d%s\n", win->start + win->trigger,
+             invalid ? " (invalid)" : "");
     putsUart0(str);
-//
-//    //mic3 circular buffer
-    if(avg_phase == 2)
+    if (displayTdoa)
+        printTdoa();
+    if (displayAoa)
+        printAoa();
+    if (displayFail && !invalid && aoa_fail)
     {
-        sum3 -= avg_arr3[index3];  //oldest
-        sum3 += mic3_raw;     //newest
-        avg_arr3[index3] = mic3_raw;
-        index3 = (index3 + 1) % N;
-        mic3_avg = sum3 / N;
+        snprintf(str, sizeof(str), "Fail: delays disagree (residual %d/256 sample)\n\n",
+                 aoa_residual);
+        putsUart0(str);
+    }
+}
 
-        avg_phase = 0;
+// Account for samples lost in the FIFOs or to a uDMA stall since the last
+// block; any loss marks the data of the current event as invalid
+void checkLosses()
+{
+    uint32_t stalls = getAdc0Ss1DmaStallCount() + getAdc1Ss1DmaStallCount();
+    bool lost = updateAdc0LossCounters();
+    lost |= updateAdc1LossCounters();
+    if (stalls != dma_stalls)
+    {
+        dma_stalls = stalls;
+        lost = true;
     }
+    if (lost)
+    {
+        loss_events++;
+        last_loss_seq = seq_count;
+        data_invalid = true;
+    }
+}
 
-    snprintf(str, sizeof(str), "mic3 avg:    %d\n\n", mic3_avg);
-    putsUart0(str);
+// ADC0 SS1 vector, fired by uDMA once per filled block and by the
+// digital comparators when a sound crosses the trigger level
+// ADC1 is triggered on the same edge and finishes its single step first,
+// so its matching block is complete (or nearly so) when this runs
+void readIsr()
+{
+    int16_t *block0, *block1;
+    int16_t mic1, mic2, mic3;
+    int16_t frames[BLOCK_SEQS * 3];
+    uint16_t i, count;
+    uint32_t start, cycles;
 
+    if (clearAdc0ComparatorInterrupt())
+    {
+        //a new event starts clean unless samples are lost during it
+        if (!processing)
+            data_invalid = false;
+        processing = true;
+        quiet_blocks = 0;
+    }
 
+    //process every completed block, oldest first, paired with the ADC1 block
+    //of the same count; if that block does not come, the ADC0 block is
+    //dropped as a loss and the late ADC1 block is dropped when it arrives
+    while ((block0 = getAdc0Ss1DmaBlock()) != 0)
+    {
+        while (adc1_owed > 0 && getAdc1Ss1DmaBlock() != 0)
+            adc1_owed--;
+        start = getCycleCount();
+        while ((block1 = getAdc1Ss1DmaBlock()) == 0 && getElapsedCycles(start) < ADC1_WAIT_CYCLES);
+        seq_count += BLOCK_SEQS;
+        checkLosses();
+        if (block1 == 0)
+        {
+            adc1_owed++;
+            adc1_timeouts++;
+            loss_events++;
+            last_loss_seq = seq_count;
+            data_invalid = true;
+            continue;
+        }
+
+        //decimate and align into frames of three mics; decimators run in
+        //lockstep, so all three are ready together
+        start = getCycleCount();
+        count = 0;
+        for (i = 0; i < BLOCK_SEQS; i++)
+        {
+            filterCicDecimator(&mic_cic[0], block0[i * ADC0_STEPS], &mic1);
+            filterCicDecimator(&mic_cic[1], block1[i * ADC1_STEPS], &mic2);
+            if (filterCicDecimator(&mic_cic[2], block0[i * ADC0_STEPS + 1], &mic3))
+            {
+                frames[count * 3] = filterFracDelay(&mic_align[0], mic1);
+                frames[count * 3 + 1] = filterFracDelay(&mic_align[1], mic2);
+                frames[count * 3 + 2] = filterFracDelay(&mic_align[2], mic3);
+                updateAverages(frames[count * 3], frames[count * 3 + 1], frames[count * 3 + 2]);
+                count++;
+            }
+        }
+        filterFilterBank(&mic_filter, frames, count);
+        updateSplMeter(&mic_spl, frames, count);
+
+        //every frame feeds the pre-trigger ring and the onset detectors;
+        //the threshold check only runs while processing, and a trigger is
+        //taken before the onsets so a group completing on the trigger
+        //sample already falls in the held window
+        activity = false;
+        for (i = 0; i < count; i++)
+        {
+            mic1 = frames[i * 3];
+            mic2 = frames[i * 3 + 1];
+            mic3 = frames[i * 3 + 2];
+            writeCapture(mic1, mic2, mic3);
+            if (processing)
+                processSample(mic1, mic2, mic3);
+            updateNoiseFloor(&mic_noise[0], mic1);
+            updateNoiseFloor(&mic_noise[1], mic2);
+            updateNoiseFloor(&mic_noise[2], mic3);
+            detectOnsets(mic1, mic2, mic3);
+            detectStaLta(getCaptureCount() - 1);
+            if (tdoa_engine == TDOA_SLIDE)
+                updateSlideCorrs(getCaptureCount() - 1);
+        }
+
+        updateTriggers();
+        cycles = getElapsedCycles(start);
+        if (cycles > block_cycles)
+            block_cycles = cycles;
+        if (!processing)
+            continue;
+
+        if (activity)
+            quiet_blocks = 0;
+        else if (++quiet_blocks >= QUIET_BLOCKS)
+            processing = false;
+    }
 
-    ADC0_PSSI_R |= ADC_PSSI_SS1;
     //clear interrupt
     ADC0_ISC_R = ADC_ISC_IN1;
 }
@@ -186,18 +883,14 @@ void initHw()
     enablePort(PORTE);
     selectPinAnalogInput(MIC1);
     selectPinAnalogInput(MIC2);
-
-    enableNvicInterrupt(SS1_VECTOR);
-
 }
 
 
-//UI
+//UI: run the command line just completed in data
 void processShell()
 {
     char str[80];
     bool knownCommand = false;
-    getsUart0(&data);
     parseFields(&data);
 
     if(isCommand(&data, "reset", 0))
@@ -209,8 +902,19 @@ void processShell()
     if(isCommand(&data, "average", 0))
     {
         //avg value of each mic in DAC and SPL (dB) units
-        snprintf(str, sizeof(str), "Microphone 1 average: %d \nMicrophone 2 average: %d \nMicrophone 3 average: %d \n\n", mic1_avg, mic2_avg, mic3_avg);
+        snprintf(str, sizeof(str), "Microphone 1 average: %d \nMicrophone 2 average: %d \nMicrophone 3 average: %d \n\n",
+                 mic1_avg >> CIC_FRAC_BITS, mic2_avg >> CIC_FRAC_BITS, mic3_avg >> CIC_FRAC_BITS);
         putsUart0(str);
+        uint8_t mic;
+        for (mic = 0; mic < 3; mic++)
+        {
+            int32_t db10 = (getSplDbQ8(&mic_spl, mic) * 10 + SPL_DB_Q8 / 2) >> 8;
+            int32_t rms10 = getCountsX10(getSplRms(&mic_spl, mic));
+            snprintf(str, sizeof(str), "Microphone %d level: %s%d.%d dB SPL (%d.%d counts RMS)\n", mic + 1,
+                     db10 < 0 ? "-" : "", abs(db10) / 10, abs(db10) % 10, rms10 / 10, rms10 % 10);
+            putsUart0(str);
+        }
+        putsUart0("\n");
 
         knownCommand = true;
     }
@@ -220,6 +924,9 @@ void processShell()
         if(data.fieldCount > 1)
         {
             time_constant = getFieldInteger(&data, 1);
+            disableNvicInterrupt(SS1_VECTOR);
+            setAverages();
+            enableNvicInterrupt(SS1_VECTOR);
         }
         knownCommand = true;
     }
@@ -229,6 +936,9 @@ void processShell()
         if(data.fieldCount > 1)
         {
             backoff_val = getFieldInteger(&data, 1);
+            disableNvicInterrupt(SS1_VECTOR);
+            setOnsetDetectors();
+            enableNvicInterrupt(SS1_VECTOR);
         }
         knownCommand = true;
     }
@@ -238,6 +948,9 @@ void processShell()
         if(data.fieldCount > 1)
         {
             holdoff_val = getFieldInteger(&data, 1);
+            disableNvicInterrupt(SS1_VECTOR);
+            setOnsetDetectors();
+            enableNvicInterrupt(SS1_VECTOR);
         }
         knownCommand = true;
     }
@@ -247,23 +960,107 @@ void processShell()
         if(data.fieldCount > 1)
         {
             hysteresis_val = getFieldInteger(&data, 1);
+            disableNvicInterrupt(SS1_VECTOR);
+            setTriggerComparators();
+            setOnsetDetectors();
+            enableNvicInterrupt(SS1_VECTOR);
         }
         knownCommand = true;
     }
 
-    if(isCommand(&data, "aoa", 0))
+    if(isCommand(&data, "rate", 1))
+    {
+        //converter rate in ksps: 125, 250, 500 or 1000
+        disableNvicInterrupt(SS1_VECTOR);
+        stopTimer1();
+        if (!setSampling(getFieldInteger(&data, 1) * 1000, oversample_log2))
+            putsUart0("Invalid rate\n");
+        startTimer1();
+        enableNvicInterrupt(SS1_VECTOR);
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "oversample", 1))
+    {
+        //oversample-then-decimate factor: 1 (off), 2, 4 or 8
+        uint32_t factor = getFieldInteger(&data, 1);
+        uint8_t log2Factor = 0;
+        while (log2Factor <= MAX_OVERSAMPLE_LOG2 && (1u << log2Factor) < factor)
+            log2Factor++;
+        disableNvicInterrupt(SS1_VECTOR);
+        stopTimer1();
+        if ((1u << log2Factor) != factor || !setSampling(conversion_rate, log2Factor))
+            putsUart0("Invalid oversample factor\n");
+        startTimer1();
+        enableNvicInterrupt(SS1_VECTOR);
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "sampling", 0))
+    {
+        snprintf(str, sizeof(str), "Converter: %d sps  Sequence: %d Hz  Decimate: %d  Output: %d Hz\n",
+                 conversion_rate, getAdc0Ss1Rate(), 1 << oversample_log2, getAdc0Ss1Rate() >> oversample_log2);
+        putsUart0(str);
+        //worst block since the last report against the time one block takes
+        snprintf(str, sizeof(str), "ISR load: %d of %d cycles per block\n\n", block_cycles,
+                 BLOCK_SEQS * (SYSTEM_CLOCK_HZ / getAdc0Ss1Rate()));
+        putsUart0(str);
+        block_cycles = 0;
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "skew", 0))
     {
-        snprintf(str, sizeof(str), "Current Angle of Arrival: %d (theta)\n\n", aoa_val);
+        //sampling offset of each mic from the common trigger
+        snprintf(str, sizeof(str), "Sample skew (ns) mic1: %d mic2: %d mic3: %d\n\n", mic_skew_ns[0], mic_skew_ns[1], mic_skew_ns[2]);
         putsUart0(str);
         knownCommand = true;
     }
 
+    if(isCommand(&data, "losses", 0))
+    {
+        //per-sequencer FIFO overflow/underflow events and uDMA stalls
+        uint8_t ss;
+        for (ss = 0; ss < 4; ss++)
+        {
+            snprintf(str, sizeof(str), "SS%d  ADC0 ov: %d uv: %d  ADC1 ov: %d uv: %d\n", ss,
+                     getAdc0OverflowCount(ss), getAdc0UnderflowCount(ss),
+                     getAdc1OverflowCount(ss), getAdc1UnderflowCount(ss));
+            putsUart0(str);
+        }
+        snprintf(str, sizeof(str), "uDMA stalls: %d  ADC1 timeouts: %d  Loss events: %d\n", dma_stalls,
+                 adc1_timeouts, loss_events);
+        putsUart0(str);
+        if (loss_events > 0)
+        {
+            snprintf(str, sizeof(str), "Last loss at sequence %d (%d ms)\n", last_loss_seq,
+                     (uint32_t)((uint64_t)last_loss_seq * 1000 / getAdc0Ss1Rate()));
+            putsUart0(str);
+        }
+        putsUart0(data_invalid ? "Current data: invalid\n\n" : "Current data: valid\n\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "aoa", 0))
+    {
+        printAoa();
+        if (data_invalid)
+            putsUart0("(samples were lost during this event)\n\n");
+        knownCommand = true;
+    }
+
     if(isCommand(&data, "aoa", 1))
     {
        displayAoa = true;
        knownCommand = true;
     }
 
+    if(isCommand(&data, "tdoa", 0) && data.fieldCount == 1)
+    {
+        printTdoa();
+        knownCommand = true;
+    }
+
     if(isCommand(&data, "tdoa", 1))
     {
         //tdoa_display = getFieldString(&data, 1);
@@ -275,6 +1072,199 @@ void processShell()
         knownCommand = true;
     }
 
+    if(isCommand(&data, "engine", 1))
+    {
+        if(strCmp(&data, "phat"))
+            tdoa_engine = TDOA_PHAT;
+        else if(strCmp(&data, "xcorr"))
+            tdoa_engine = TDOA_XCORR;
+        else if(strCmp(&data, "onset"))
+            tdoa_engine = TDOA_ONSET;
+        else if(strCmp(&data, "sign"))
+            tdoa_engine = TDOA_SIGN;
+        else if(strCmp(&data, "seeded"))
+            tdoa_engine = TDOA_SEEDED;
+        else if(strCmp(&data, "slide"))
+        {
+            //start the sums from what is in the rings now
+            disableNvicInterrupt(SS1_VECTOR);
+            if (setSlideCorr())
+                tdoa_engine = TDOA_SLIDE;
+            enableNvicInterrupt(SS1_VECTOR);
+            if (!slide_valid)
+            {
+                snprintf(str, sizeof(str), "Mics need +/-%d lags, slide has %d\n", slide_lag,
+                         SLIDE_MAX_LAG);
+                putsUart0(str);
+            }
+        }
+        else
+            putsUart0("Engines: xcorr, phat, onset, sign, seeded, slide\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "mic", 3))
+    {
+        //mic <1-3> <x mm> <y mm>
+        int32_t mic = getFieldInteger(&data, 1);
+        int32_t x = getFieldInteger(&data, 2);
+        int32_t y = getFieldInteger(&data, 3);
+        if (mic < 1 || mic > 3)
+            putsUart0("Mics are 1 to 3\n");
+        else if (x < -MIC_MAX_MM || x > MIC_MAX_MM || y < -MIC_MAX_MM || y > MIC_MAX_MM)
+            putsUart0("Positions are -1000 to 1000 mm\n");
+        else
+        {
+            mic_x_mm[mic - 1] = x;
+            mic_y_mm[mic - 1] = y;
+            disableNvicInterrupt(SS1_VECTOR);
+            aoa_table_valid = isDefaultMicLayout() && initAoaTable(MIC_SPACING_MM, SAMPLE_RATE);
+            setOnsetDetectors();
+            if (tdoa_engine == TDOA_SLIDE)
+                setSlideCorr();
+            enableNvicInterrupt(SS1_VECTOR);
+            if (tdoa_engine == TDOA_SLIDE && !slide_valid)
+            {
+                snprintf(str, sizeof(str), "Mics need +/-%d lags, slide has %d: results invalid\n",
+                         slide_lag, SLIDE_MAX_LAG);
+                putsUart0(str);
+            }
+        }
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "mic", 0) && data.fieldCount == 1)
+    {
+        uint8_t mic;
+        for (mic = 0; mic < 3; mic++)
+        {
+            snprintf(str, sizeof(str), "MIC%d: x %d mm  y %d mm\n", mic + 1, mic_x_mm[mic], mic_y_mm[mic]);
+            putsUart0(str);
+        }
+        putsUart0("\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "band", 2))
+    {
+        //band <low Hz> <high Hz>, 0 leaves that side open
+        uint32_t low = getFieldInteger(&data, 1);
+        uint32_t high = getFieldInteger(&data, 2);
+        bool ok;
+        disableNvicInterrupt(SS1_VECTOR);
+        ok = setFilterBankBand(&mic_filter, low, high, SAMPLE_RATE);
+        enableNvicInterrupt(SS1_VECTOR);
+        if (ok)
+        {
+            band_low_hz = low;
+            band_high_hz = high;
+        }
+        else
+            putsUart0("Invalid band\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "band", 0) && data.fieldCount == 1)
+    {
+        snprintf(str, sizeof(str), "Band: %d Hz to %d Hz\n\n", band_low_hz, band_high_hz);
+        putsUart0(str);
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "cal", 2))
+    {
+        //cal <1-3> <dB SPL at 1 count RMS, in 0.1 dB>
+        int32_t mic = getFieldInteger(&data, 1);
+        if (mic >= 1 && mic <= 3)
+            setSplOffset(&mic_spl, mic - 1, getFieldInteger(&data, 2) * SPL_DB_Q8 / 10 - SPL_Q3_DB_Q8);
+        else
+            putsUart0("Mics are 1 to 3\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "margin", 1))
+    {
+        //trigger margin above the noise floor in dB
+        int32_t db = getFieldInteger(&data, 1);
+        if (db >= 0 && db <= NOISE_MAX_MARGIN_DB)
+            margin_db = db;
+        else
+            putsUart0("Margin is 0 to 48 dB\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "floor", 0))
+    {
+        uint8_t mic;
+        for (mic = 0; mic < 3; mic++)
+        {
+            int32_t floor10 = getCountsX10(getNoiseFloor(&mic_noise[mic]));
+            int32_t trigger10 = getCountsX10(mic_trigger[mic]);
+            snprintf(str, sizeof(str), "Microphone %d floor: %d.%d  trigger: %d.%d counts (+%d dB)\n",
+                     mic + 1, floor10 / 10, floor10 % 10, trigger10 / 10, trigger10 % 10, margin_db);
+            putsUart0(str);
+        }
+        putsUart0("\n");
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "stalta", 4))
+    {
+        //stalta <sta samples> <lta samples> <on ratio x10> <off ratio x10>
+        //ratios must stay below 256.0 to fit the Q8 detector settings
+        uint16_t sta = sta_len, lta = lta_len, on = sta_on10, off = sta_off10;
+        int32_t staIn = getFieldInteger(&data, 1);
+        int32_t ltaIn = getFieldInteger(&data, 2);
+        int32_t onIn = getFieldInteger(&data, 3);
+        int32_t offIn = getFieldInteger(&data, 4);
+        if (staIn < 1 || ltaIn < 1 || ltaIn > CAPTURE_LEN / 2
+            || onIn < 0 || onIn > STA_MAX_RATIO10 || offIn < 0 || offIn > STA_MAX_RATIO10)
+            putsUart0("Invalid STA/LTA settings\n");
+        else
+        {
+            sta_len = staIn;
+            lta_len = ltaIn;
+            sta_on10 = onIn;
+            sta_off10 = offIn;
+            disableNvicInterrupt(SS1_VECTOR);
+            if (!setStaLta())
+            {
+                putsUart0("Invalid STA/LTA settings\n");
+                sta_len = sta;
+                lta_len = lta;
+                sta_on10 = on;
+                sta_off10 = off;
+                setStaLta();
+            }
+            enableNvicInterrupt(SS1_VECTOR);
+        }
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "stalta", 0) && data.fieldCount == 1)
+    {
+        snprintf(str, sizeof(str), "STA %d  LTA %d samples  on %d.%d  off %d.%d\n", sta_len, lta_len,
+                 sta_on10 / 10, sta_on10 % 10, sta_off10 / 10, sta_off10 % 10);
+        putsUart0(str);
+        snprintf(str, sizeof(str), "Ratios: %d %d %d (x256)\n\n", getStaLtaRatioQ8(&mic_stalta[0]),
+                 getStaLtaRatioQ8(&mic_stalta[1]), getStaLtaRatioQ8(&mic_stalta[2]));
+        putsUart0(str);
+        knownCommand = true;
+    }
+
+    if(isCommand(&data, "slide", 0))
+    {
+        //lags, window, memory (correlators plus kept vectors) and ISR cost
+        snprintf(str, sizeof(str), "Sliding correlator: +/-%d lags over %d samples%s\n", slide_lag,
+                 CAPTURE_PRE + CAPTURE_POST, slide_valid ? "" : " (too wide)");
+        putsUart0(str);
+        snprintf(str, sizeof(str), "Memory: %d bytes  Update: %d cycles/sample%s\n\n",
+                 (int)(sizeof(pair_corr) + sizeof(slide_vector)), slide_cycles,
+                 tdoa_engine == TDOA_SLIDE ? "" : " (idle)");
+        putsUart0(str);
+        knownCommand = true;
+    }
+
     if(isCommand(&data, "fail", 1))
     {
         //fail_display = getFieldString(&data, 1);
@@ -300,32 +1290,59 @@ int main(void)
     // Initialize hardware
     initHw();
     initUart0();
-    initAdc0Ss1();
+    initAdc0Ss1Timed(SAMPLE_RATE);
 
-    int count = 0;
+    CAPTURE_WINDOW win;
 
     // Setup UART0 baud rate
     setUart0BaudRate(115200, 40e6);
 
     setPinValue(RED_LED, 0);
 
+    //hold triggers until both converters and uDMA are ready,
+    //so ADC0 and ADC1 blocks cover the same sequences
+    stopTimer1();
+    initAdc1Ss1();
+    selectAdc1Ss1TimerTrigger();
+
     //set analog inputs ( + hardware sampling rate?)
-    setAdc0Ss1Mux();
+    setAdc0Ss1Sequence(adc0_ain, ADC0_STEPS + ADC0_DC_STEPS);
+    setAdc0Ss1StepComparator(ADC0_STEPS, 0);
+    setAdc0Ss1StepComparator(ADC0_STEPS + 1, 1);
+    initNoiseFloors();
+    enableAdc0ComparatorInterrupt();
+    setAdc1Ss1Sequence(adc1_ain, ADC1_STEPS);
     setAdc0Ss1Log2AverageCount(0);
-    ADC0_PSSI_R |= ADC_PSSI_SS1;                     // set start bit
+    setAdc1Ss1Log2AverageCount(0);
+    initAdc0Ss1Dma(adc0_ping, adc0_pong, BLOCK_SEQS * ADC0_STEPS);
+    initAdc1Ss1Dma(adc1_ping, adc1_pong, BLOCK_SEQS * ADC1_STEPS);
+    setSampling(conversion_rate, oversample_log2);
+    initFilterBank(&mic_filter, DC_SHIFT);
+    setFilterBankBand(&mic_filter, band_low_hz, band_high_hz, SAMPLE_RATE);
+    initSplMeter(&mic_spl, SPL_LOG2_BLOCKS, SPL_OFFSET_Q8);
+    initCapture();
+    setStaLta();
+    setSlideCorr();
+    setOnsetDetectors();
+    setAverages();
+    aoa_table_valid = initAoaTable(MIC_SPACING_MM, SAMPLE_RATE);
+    initCycleCounter();
+
+    enableNvicInterrupt(SS1_VECTOR);
+    startTimer1();
 
     while(true)
     {
-//        mic1_raw = readAdc0Ss1();
-//        if(count == 3)
-//        {
-//            count = 0;
-//            ADC0_PSSI_R |= ADC_PSSI_SS1;                     // set start bit
-//        }
-//        count++;
-        //waitMicrosecond(500000);
-        //ADC0_PSSI_R |= ADC_PSSI_SS1;
-
-        processShell();
+        //take whatever the user has typed so far; a command runs only once
+        //its line is complete, so the loop never waits on the keyboard
+        if (getsUart0NoWait(&data))
+            processShell();
+
+        if (raw_pending)
+            printRaw();
+
+        //hand a finished pre/post-trigger window to the localization code
+        if (getCaptureWindow(&win))
+            processEvent(&win);
     }
 }
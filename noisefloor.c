@@ -0,0 +1,82 @@
+// Noise Floor Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "noisefloor.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// 10^(dB/20) in Q8 for 0 to NOISE_MAX_MARGIN_DB dB
+const uint16_t dbGain[NOISE_MAX_MARGIN_DB + 1] =
+{
+    256, 287, 322, 362, 406, 455, 511, 573, 643, 722,
+    810, 908, 1019, 1144, 1283, 1440, 1615, 1812, 2033, 2282,
+    2560, 2872, 3223, 3616, 4057, 4552, 5108, 5731, 6430, 7215,
+    8095, 9083, 10192, 11435, 12830, 14396, 16153, 18123, 20335, 22816,
+    25600, 28724, 32228, 36161, 40573, 45524, 51079, 57311, 64304
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Time constants are 2^shift samples: envShift smooths |x|, and the floor
+// moves toward the envelope with fallShift below it and riseShift above it
+void initNoiseFloor(NOISE_FLOOR *nf, uint8_t envShift, uint8_t fallShift, uint8_t riseShift,
+                    uint16_t floorCounts)
+{
+    nf->envShift = envShift;
+    nf->fallShift = fallShift;
+    nf->riseShift = riseShift;
+    nf->floor = (uint64_t)floorCounts << (8 + riseShift);
+    nf->env = (uint32_t)floorCounts << (8 + envShift);
+}
+
+// O(1) per sample: two shift-only averages and one compare
+void updateNoiseFloor(NOISE_FLOOR *nf, int16_t x)
+{
+    uint32_t a = (uint32_t)(x < 0 ? -x : x) << 8;
+    uint64_t e;
+
+    nf->env += a - (nf->env >> nf->envShift);
+    e = (uint64_t)(nf->env >> nf->envShift) << nf->riseShift;
+    if (e < nf->floor)
+        nf->floor -= (nf->floor - e + (1 << nf->fallShift) - 1) >> nf->fallShift;
+    else
+        nf->floor += (e - nf->floor) >> nf->riseShift;
+}
+
+// Floor in counts (mean |x| of the background)
+uint16_t getNoiseFloor(const NOISE_FLOOR *nf)
+{
+    return nf->floor >> (8 + nf->riseShift);
+}
+
+// Trigger level marginDb above the floor, and at least minCounts
+uint16_t getNoiseThreshold(const NOISE_FLOOR *nf, uint8_t marginDb, uint16_t minCounts)
+{
+    uint32_t t;
+    if (marginDb > NOISE_MAX_MARGIN_DB)
+        marginDb = NOISE_MAX_MARGIN_DB;
+    t = ((nf->floor >> nf->riseShift) * dbGain[marginDb]) >> 16;
+    if (t < minCounts)
+        t = minCounts;
+    if (t > 32767)
+        t = 32767;
+    return t;
+}
@@ -0,0 +1,46 @@
+// Noise Floor Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef NOISEFLOOR_H_
+#define NOISEFLOOR_H_
+
+#include <stdint.h>
+
+#define NOISE_MAX_MARGIN_DB 48
+
+// Minimum-tracking noise floor of one zero-mean channel: a short envelope
+// of |x|, and a floor that follows the envelope down quickly but up only
+// slowly, so it settles on the quiet stretches between events
+typedef struct _NOISE_FLOOR
+{
+    uint32_t env;                                    // |x| envelope * 2^envShift, Q8
+    uint64_t floor;                                  // floor * 2^riseShift, Q8
+    uint8_t envShift;
+    uint8_t fallShift;
+    uint8_t riseShift;
+} NOISE_FLOOR;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initNoiseFloor(NOISE_FLOOR *nf, uint8_t envShift, uint8_t fallShift, uint8_t riseShift,
+                    uint16_t floorCounts);
+void updateNoiseFloor(NOISE_FLOOR *nf, int16_t x);
+uint16_t getNoiseFloor(const NOISE_FLOOR *nf);
+uint16_t getNoiseThreshold(const NOISE_FLOOR *nf, uint8_t marginDb, uint16_t minCounts);
+
+#endif
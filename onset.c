@@ -0,0 +1,118 @@
+// Onset Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "onset.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Set the parameters and return to the idle, armed state
+void initOnsetDetector(ONSET_DETECTOR *od, int16_t level, uint16_t hysteresis,
+                       uint32_t holdoff, uint16_t backoff, uint8_t decayShift)
+{
+    od->level = level;
+    od->hysteresis = hysteresis;
+    od->holdoff = holdoff;
+    od->backoff = backoff;
+    od->decayShift = decayShift;
+    od->holdoffLeft = 0;
+    od->raise = 0;
+    od->armed = true;
+    od->time = 0;
+}
+
+// Move the base threshold without disturbing the detector state
+void setOnsetLevel(ONSET_DETECTOR *od, int16_t level)
+{
+    od->level = level;
+}
+
+// Feed one sample taken at the given sample index
+// An onset is the first sample whose magnitude is above the threshold
+// (level plus the decaying backoff raise) while armed and outside the
+// holdoff, so a wavefront arriving negative-first counts as well; the
+// detector re-arms once the magnitude falls below the threshold by the
+// hysteresis
+// Returns true on an onset, with its sample index stored in od->time
+bool detectOnset(ONSET_DETECTOR *od, int16_t x, uint32_t time)
+{
+    int32_t threshold;
+    int32_t m = x < 0 ? -x : x;
+
+    od->raise -= (od->raise + (1 << od->decayShift) - 1) >> od->decayShift;
+    threshold = od->level + od->raise;
+    if (threshold > 32767)
+        threshold = 32767;
+
+    if (od->holdoffLeft > 0)
+    {
+        //signal that is still loud when the holdoff ends must re-arm first
+        od->holdoffLeft--;
+        if (m > threshold)
+            od->armed = false;
+    }
+
+    if (!od->armed)
+    {
+        if (m < threshold - od->hysteresis)
+            od->armed = true;
+        return false;
+    }
+
+    if (m > threshold && od->holdoffLeft == 0)
+    {
+        od->armed = false;
+        od->holdoffLeft = od->holdoff;
+        od->raise += od->backoff;
+        od->time = time;
+        return true;
+    }
+    return false;
+}
+
+void initOnsetGroup(ONSET_GROUP *group, uint16_t window)
+{
+    group->window = window;
+    group->seen = 0;
+}
+
+// Add an onset of one mic; an onset after a complete group or more than
+// window samples after the first one of the group starts a new group, and
+// a repeat onset of a mic already in the group is ignored
+// Returns true when the group holds an onset from every mic
+bool addOnset(ONSET_GROUP *group, uint8_t mic, uint32_t time)
+{
+    bool complete = group->seen == (1 << ONSET_MICS) - 1;
+    if (group->seen != 0 && (complete || time - group->first > group->window))
+        group->seen = 0;
+    if (group->seen == 0)
+        group->first = time;
+    if ((group->seen & (1 << mic)) == 0)
+    {
+        group->time[mic] = time;
+        group->seen |= 1 << mic;
+    }
+    return group->seen == (1 << ONSET_MICS) - 1;
+}
+
+// Lag of mic b after mic a in samples
+int16_t getOnsetLag(const ONSET_GROUP *group, uint8_t a, uint8_t b)
+{
+    return (int32_t)(group->time[b] - group->time[a]);
+}
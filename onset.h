@@ -0,0 +1,60 @@
+// Onset Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef ONSET_H_
+#define ONSET_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ONSET_MICS 3
+
+// Threshold crossing detector for one mic
+typedef struct _ONSET_DETECTOR
+{
+    int16_t level;                                   // base threshold
+    uint16_t hysteresis;                             // re-arm below threshold - hysteresis
+    uint16_t backoff;                                // threshold raise per onset
+    uint8_t decayShift;                              // raise decays 1/2^decayShift per sample
+    uint32_t holdoff;                                // samples after an onset with no new onset
+    uint32_t holdoffLeft;
+    uint32_t raise;
+    bool armed;
+    uint32_t time;                                   // sample index of the last onset
+} ONSET_DETECTOR;
+
+// Onsets of one event on all mics, no more than window samples apart
+typedef struct _ONSET_GROUP
+{
+    uint32_t time[ONSET_MICS];
+    uint32_t first;
+    uint16_t window;
+    uint8_t seen;                                    // bit per mic
+} ONSET_GROUP;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initOnsetDetector(ONSET_DETECTOR *od, int16_t level, uint16_t hysteresis,
+                       uint32_t holdoff, uint16_t backoff, uint8_t decayShift);
+void setOnsetLevel(ONSET_DETECTOR *od, int16_t level);
+bool detectOnset(ONSET_DETECTOR *od, int16_t x, uint32_t time);
+void initOnsetGroup(ONSET_GROUP *group, uint16_t window);
+bool addOnset(ONSET_GROUP *group, uint8_t mic, uint32_t time);
+int16_t getOnsetLag(const ONSET_GROUP *group, uint8_t a, uint8_t b);
+
+#endif
@@ -0,0 +1,96 @@
+// Sliding Cross-Correlation Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tdoa.h"
+#include "slidecorr.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Attach to two rings (sample k at ring[k & mask]) whose next samples will
+// be written at index next; the sums start from the samples already there
+// Lags run from -maxLag to maxLag (0 <= maxLag <= SLIDE_MAX_LAG) and the
+// window plus the lag span must be shorter than the ring, since the oldest
+// sample dropped is length + 2 maxLag before the newest and must not be
+// the slot the newest has just overwritten
+// Returns false for parameters out of range
+bool initSlideCorr(SLIDE_CORR *sc, const int16_t *a, const int16_t *b, uint16_t mask,
+                   uint32_t next, uint16_t length, int16_t maxLag)
+{
+    uint32_t n;
+    uint16_t k;
+    int16_t d;
+
+    if (maxLag < 0 || maxLag > SLIDE_MAX_LAG || length == 0
+        || length + 2 * maxLag > mask)
+        return false;
+    sc->a = a;
+    sc->b = b;
+    sc->mask = mask;
+    sc->length = length;
+    sc->maxLag = maxLag;
+    for (d = -maxLag; d <= maxLag; d++)
+    {
+        sc->acc[maxLag + d] = 0;
+        for (k = 1; k <= length; k++)
+        {
+            n = next - 1 - maxLag - length + k;
+            sc->acc[maxLag + d] += (int32_t)a[n & mask] * b[(n + d) & mask];
+        }
+    }
+    return true;
+}
+
+// Account for the sample just written at index: 2 * (2 * maxLag + 1)
+// multiply-accumulates, independent of the window length
+void updateSlideCorr(SLIDE_CORR *sc, uint32_t index)
+{
+    uint32_t n = index - sc->maxLag;
+    uint32_t o = n - sc->length;
+    int32_t x = sc->a[n & sc->mask];
+    int32_t y = sc->a[o & sc->mask];
+    int64_t *acc = sc->acc + sc->maxLag;
+    int16_t d;
+
+    for (d = -sc->maxLag; d <= sc->maxLag; d++)
+    {
+        acc[d] += x * sc->b[(n + d) & sc->mask];
+        acc[d] -= y * sc->b[(o + d) & sc->mask];
+    }
+}
+
+// Peak of a correlation vector acc[0..2 maxLag] (lag -maxLag first)
+// Returns the lag of the peak; positive means b hears the sound after a
+// If lagQ8 is not null, it receives the peak lag refined to 1/256 sample
+int16_t getSlideCorrLag(const int64_t *acc, int16_t maxLag, int32_t *lagQ8)
+{
+    int16_t best = 0;
+    int16_t k;
+
+    for (k = 1; k <= 2 * maxLag; k++)
+        if (acc[k] > acc[best])
+            best = k;
+    if (lagQ8)
+    {
+        *lagQ8 = (int32_t)(best - maxLag) << 8;
+        if (best > 0 && best < 2 * maxLag)
+            *lagQ8 += interpolateTdoaPeak(acc[best - 1], acc[best], acc[best + 1]);
+    }
+    return best - maxLag;
+}
@@ -0,0 +1,51 @@
+// Sliding Cross-Correlation Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SLIDECORR_H_
+#define SLIDECORR_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Largest lag (samples) kept; accumulators take 8 * (2 * SLIDE_MAX_LAG + 1)
+// bytes per pair
+#define SLIDE_MAX_LAG 8
+
+// Streaming cross-correlation of two channels of sample rings:
+// acc[maxLag + d] = sum a[n] * b[n + d] over the length samples of a that
+// end maxLag samples before the newest, so every lag has its b samples
+// written already and all lags share the same n range
+// Each new sample adds one product per lag and drops the one that left
+typedef struct _SLIDE_CORR
+{
+    const int16_t *a;
+    const int16_t *b;
+    uint16_t mask;
+    uint16_t length;
+    int16_t maxLag;
+    int64_t acc[2 * SLIDE_MAX_LAG + 1];
+} SLIDE_CORR;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool initSlideCorr(SLIDE_CORR *sc, const int16_t *a, const int16_t *b, uint16_t mask,
+                   uint32_t next, uint16_t length, int16_t maxLag);
+void updateSlideCorr(SLIDE_CORR *sc, uint32_t index);
+int16_t getSlideCorrLag(const int64_t *acc, int16_t maxLag, int32_t *lagQ8);
+
+#endif
@@ -0,0 +1,130 @@
+// Sound Pressure Level Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include "spl.h"
+
+// 10 log10(2) in Q16 (dB per octave of mean square)
+#define DB_PER_LOG2_Q16 197283
+
+// Fraction bits kept on the block mean squares
+#define MS_FRAC_BITS 8
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// log2(1 + i/32) in Q16
+const uint32_t log2Table[33] =
+{
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65536
+};
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// log2(x) in Q16 for x >= 1 (0 for x = 0): the exponent is the position of
+// the top bit, and the next 5 bits index the table with the 11 after them
+// interpolating between entries (error below 0.00021, about 0.0006 dB)
+int32_t log2Q16(uint64_t x)
+{
+    uint8_t e = 0;
+    uint32_t m, i, f;
+
+    if (x == 0)
+        return 0;
+    while ((x >> e) > 1)
+        e++;
+    //mantissa bits below the top one, left aligned in 16 bits
+    m = e >= 16 ? (uint32_t)(x >> (e - 16)) & 0xFFFF : (uint32_t)(x << (16 - e)) & 0xFFFF;
+    i = m >> 11;
+    f = m & 0x7FF;
+    return ((int32_t)e << 16) + log2Table[i]
+           + (((log2Table[i + 1] - log2Table[i]) * f + (1 << 10)) >> 11);
+}
+
+// Clear the levels; offsetQ8 is the dB SPL that an RMS of one input unit
+// represents (the same for every channel until calibrated)
+void initSplMeter(SPL_METER *meter, uint8_t log2Blocks, int32_t offsetQ8)
+{
+    uint8_t ch;
+    meter->log2Blocks = log2Blocks;
+    for (ch = 0; ch < SPL_CHANNELS; ch++)
+    {
+        meter->acc[ch] = 0;
+        meter->offsetQ8[ch] = offsetQ8;
+    }
+}
+
+void setSplOffset(SPL_METER *meter, uint8_t ch, int32_t offsetQ8)
+{
+    if (ch < SPL_CHANNELS)
+        meter->offsetQ8[ch] = offsetQ8;
+}
+
+// Fold the mean square of one block of interleaved zero-mean frames
+// (frames[n * SPL_CHANNELS + ch]) into the running average of each channel
+void updateSplMeter(SPL_METER *meter, const int16_t *frames, uint16_t count)
+{
+    uint64_t sum;
+    uint16_t n;
+    uint8_t ch;
+
+    if (count == 0)
+        return;
+    for (ch = 0; ch < SPL_CHANNELS; ch++)
+    {
+        sum = 0;
+        for (n = 0; n < count; n++)
+            sum += (int32_t)frames[n * SPL_CHANNELS + ch] * frames[n * SPL_CHANNELS + ch];
+        meter->acc[ch] += ((sum << MS_FRAC_BITS) / count) - (meter->acc[ch] >> meter->log2Blocks);
+    }
+}
+
+// RMS in input units (rounded down)
+uint32_t getSplRms(const SPL_METER *meter, uint8_t ch)
+{
+    uint32_t ms = meter->acc[ch] >> (meter->log2Blocks + MS_FRAC_BITS);
+    uint32_t root = 0, bit = 1u << 30;
+    while (bit > ms)
+        bit >>= 2;
+    while (bit != 0)
+    {
+        if (ms >= root + bit)
+        {
+            ms -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Level in dB SPL (Q8): 10 log10(mean square) plus the channel offset; the
+// mean square keeps its fraction bits so quiet channels still read smoothly
+int32_t getSplDbQ8(const SPL_METER *meter, uint8_t ch)
+{
+    uint64_t acc = meter->acc[ch] > 0 ? meter->acc[ch] : 1;
+    int32_t log2Ms = log2Q16(acc) - ((int32_t)(meter->log2Blocks + MS_FRAC_BITS) << 16);
+    return (int32_t)(((int64_t)log2Ms * DB_PER_LOG2_Q16) >> 24) + meter->offsetQ8[ch];
+}
@@ -0,0 +1,45 @@
+// Sound Pressure Level Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef SPL_H_
+#define SPL_H_
+
+#include <stdint.h>
+
+// Levels are dB in Q8
+#define SPL_DB_Q8    256
+#define SPL_CHANNELS 3
+
+// Running mean square per channel, averaged over 2^log2Blocks blocks
+typedef struct _SPL_METER
+{
+    uint64_t acc[SPL_CHANNELS];                      // mean square * 2^(8 + log2Blocks)
+    int32_t offsetQ8[SPL_CHANNELS];                  // dB SPL at an RMS of 1 input unit
+    uint8_t log2Blocks;
+} SPL_METER;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int32_t log2Q16(uint64_t x);
+void initSplMeter(SPL_METER *meter, uint8_t log2Blocks, int32_t offsetQ8);
+void setSplOffset(SPL_METER *meter, uint8_t ch, int32_t offsetQ8);
+void updateSplMeter(SPL_METER *meter, const int16_t *frames, uint16_t count);
+uint32_t getSplRms(const SPL_METER *meter, uint8_t ch);
+int32_t getSplDbQ8(const SPL_METER *meter, uint8_t ch);
+
+#endif
@@ -0,0 +1,111 @@
+// STA/LTA Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "stalta.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Attach to a ring (sample k at ring[k & mask]) of 16-bit data whose next
+// sample will be written at index next; the sums start from the samples
+// already in the windows. Windows are in samples (1 <= staLen < ltaLen <=
+// half the ring) and ratios in Q8 (on > off)
+// A full-scale long window sums to ltaLen * 2^30, so the cross-multiplied
+// test fits 64 bits only while ltaLen * staLen * max(on, 1.0) < 2^33
+// Returns false for parameters out of range
+bool initStaLta(STA_LTA *sl, const int16_t *ring, uint16_t mask, uint32_t next,
+                uint16_t staLen, uint16_t ltaLen, uint16_t onQ8, uint16_t offQ8)
+{
+    int32_t x;
+    uint16_t k;
+
+    if (staLen == 0 || staLen >= ltaLen || ltaLen > (mask + 1) / 2 || offQ8 >= onQ8
+        || (uint64_t)ltaLen * staLen * (onQ8 > STALTA_RATIO_Q8 ? onQ8 : STALTA_RATIO_Q8)
+           >= (1ull << 33))
+        return false;
+    sl->ring = ring;
+    sl->mask = mask;
+    sl->staLen = staLen;
+    sl->ltaLen = ltaLen;
+    sl->onQ8 = onQ8;
+    sl->offQ8 = offQ8;
+    sl->staSum = 0;
+    sl->ltaSum = 0;
+    for (k = 1; k <= ltaLen; k++)
+    {
+        x = ring[(next - k) & mask];
+        sl->ltaSum += (uint32_t)(x * x);
+        if (k <= staLen)
+            sl->staSum += (uint32_t)(x * x);
+    }
+    sl->settle = ltaLen;
+    sl->active = false;
+    sl->start = 0;
+    sl->end = 0;
+    return true;
+}
+
+// Account for the sample just written at index (constant time)
+// The ratio test is sta / staLen > on * lta / ltaLen, cross-multiplied so
+// there is no divide; the long-term energy is floored at one count^2 per
+// sample so a silent window cannot trigger on nothing, and nothing is
+// tested until one long window has passed since init
+// Returns 1 on a trigger, -1 on a de-trigger, 0 otherwise; the sample
+// index is kept in start or end
+int8_t updateStaLta(STA_LTA *sl, uint32_t index)
+{
+    int32_t x = sl->ring[index & sl->mask];
+    int32_t xs = sl->ring[(index - sl->staLen) & sl->mask];
+    int32_t xl = sl->ring[(index - sl->ltaLen) & sl->mask];
+    uint64_t sta, lta;
+
+    sl->staSum += (uint32_t)(x * x);
+    sl->staSum -= (uint32_t)(xs * xs);
+    sl->ltaSum += (uint32_t)(x * x);
+    sl->ltaSum -= (uint32_t)(xl * xl);
+    if (sl->settle > 0)
+    {
+        sl->settle--;
+        return 0;
+    }
+
+    lta = sl->ltaSum > sl->ltaLen ? sl->ltaSum : sl->ltaLen;
+    sta = sl->staSum * sl->ltaLen << 8;
+    lta *= sl->staLen;
+    if (!sl->active && sta > lta * sl->onQ8)
+    {
+        sl->active = true;
+        sl->start = index;
+        return 1;
+    }
+    if (sl->active && sta < lta * sl->offQ8)
+    {
+        sl->active = false;
+        sl->end = index;
+        return -1;
+    }
+    return 0;
+}
+
+// Current STA/LTA ratio in Q8
+uint32_t getStaLtaRatioQ8(const STA_LTA *sl)
+{
+    uint64_t lta = sl->ltaSum > sl->ltaLen ? sl->ltaSum : sl->ltaLen;
+    return (sl->staSum * sl->ltaLen << 8) / (lta * sl->staLen);
+}
@@ -0,0 +1,55 @@
+// STA/LTA Detector Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef STALTA_H_
+#define STALTA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Ratios are Q8
+#define STALTA_RATIO_Q8 256
+
+// Short-term / long-term average energy ratio detector on one channel of
+// a sample ring; both averages are running sums of squares over windows
+// that end at the newest sample, updated by adding the new sample and
+// dropping the one that left the window
+typedef struct _STA_LTA
+{
+    const int16_t *ring;
+    uint16_t mask;
+    uint16_t staLen;
+    uint16_t ltaLen;
+    uint16_t onQ8;                                   // trigger when STA/LTA rises above
+    uint16_t offQ8;                                  // de-trigger when it falls below
+    uint64_t staSum;
+    uint64_t ltaSum;
+    uint16_t settle;                                 // samples left before testing
+    bool active;
+    uint32_t start;                                  // sample index of the last trigger
+    uint32_t end;                                    // sample index of the last de-trigger
+} STA_LTA;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool initStaLta(STA_LTA *sl, const int16_t *ring, uint16_t mask, uint32_t next,
+                uint16_t staLen, uint16_t ltaLen, uint16_t onQ8, uint16_t offQ8);
+int8_t updateStaLta(STA_LTA *sl, uint32_t index);
+uint32_t getStaLtaRatioQ8(const STA_LTA *sl);
+
+#endif
@@ -0,0 +1,239 @@
+// TDOA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dsp.h"
+#include "tdoa.h"
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Largest delay (whole samples, rounded up) a wavefront can have between two
+// mics spacingMm apart
+int16_t getMaxTdoaLag(uint32_t spacingMm, uint32_t sampleRateHz)
+{
+    return ((uint64_t)spacingMm * sampleRateHz + SPEED_OF_SOUND_MM - 1) / SPEED_OF_SOUND_MM;
+}
+
+// Time-domain cross-correlation of two windows taken from rings:
+// sample k is a[(start + k) & mask]. The window means are removed, then
+// R(d) = sum a[n] * b[n + d] is evaluated for -maxLag <= d <= maxLag over
+// the same n range for every lag, so the sums compare without normalizing
+// Returns the lag of the peak; positive means b hears the sound after a
+// If lagQ8 is not null, it receives the peak lag refined to 1/256 sample
+int16_t findTdoaLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                    uint16_t mask, int16_t maxLag, int32_t *lagQ8)
+{
+    return findTdoaLagNear(a, b, start, length, mask, maxLag, 0, maxLag, lagQ8);
+}
+
+// Sum of a[(start + n) & mask] * b[(start + n + d) & mask] for n = 0 to
+// count - 1, split where either ring wraps so each run goes to dotQ15()
+int64_t dotTdoaRing(const int16_t *a, const int16_t *b, uint32_t start, uint16_t count,
+                    uint16_t mask, int16_t d)
+{
+    int64_t acc = 0;
+    uint16_t i, j, run;
+    while (count > 0)
+    {
+        i = start & mask;
+        j = (start + d) & mask;
+        run = mask + 1 - (i > j ? i : j);
+        if (run > count)
+            run = count;
+        acc += dotQ15(a + i, b + j, run);
+        start += run;
+        count -= run;
+    }
+    return acc;
+}
+
+// Same as findTdoaLag, but only lags within radius of center (and within
+// +/-maxLag) are evaluated; the sums still run over the n range of the
+// full search so they compare the same way
+// The mean-removed products are expanded as sum(a * b) - meanB * sum(a)
+// - meanA * sum(b) + count * meanA * meanB, so the inner loop is a plain
+// dot product and the sum of b slides by one sample per lag
+int16_t findTdoaLagNear(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                        uint16_t mask, int16_t maxLag, int16_t center, int16_t radius,
+                        int32_t *lagQ8)
+{
+    int16_t lo = center - radius < -maxLag ? -maxLag : center - radius;
+    int16_t hi = center + radius > maxLag ? maxLag : center + radius;
+    int32_t sumA = 0, sumB = 0, windowA = 0, windowB = 0;
+    int16_t meanA, meanB;
+    int64_t r, prev = 0, best = INT64_MIN, left = 0, right = 0;
+    int16_t bestLag = lo;
+    int16_t d;
+    uint16_t n, count;
+
+    if (lagQ8)
+        *lagQ8 = 0;
+    if (length <= 2 * maxLag)
+        return 0;
+
+    for (n = 0; n < length; n++)
+    {
+        sumA += a[(start + n) & mask];
+        sumB += b[(start + n) & mask];
+    }
+    meanA = sumA / length;
+    meanB = sumB / length;
+
+    //sums over the products' range: a fixed, b at the first lag searched
+    count = length - 2 * maxLag;
+    for (n = maxLag; n < length - maxLag; n++)
+    {
+        windowA += a[(start + n) & mask];
+        windowB += b[(start + n + lo) & mask];
+    }
+
+    for (d = lo; d <= hi; d++)
+    {
+        r = dotTdoaRing(a, b, start + maxLag, count, mask, d) - (int64_t)meanB * windowA
+          - (int64_t)meanA * windowB + (int64_t)count * meanA * meanB;
+        windowB += b[(start + length - maxLag + d) & mask] - b[(start + maxLag + d) & mask];
+        if (d == bestLag + 1)
+            right = r;
+        if (r > best)
+        {
+            best = r;
+            bestLag = d;
+            left = prev;
+        }
+        prev = r;
+    }
+
+    //a peak on the edge of the search has no neighbor outside it
+    if (lagQ8)
+    {
+        *lagQ8 = (int32_t)bestLag << 8;
+        if (bestLag > lo && bestLag < hi)
+            *lagQ8 += interpolateTdoaPeak(left, best, right);
+    }
+    return bestLag;
+}
+
+// Coarse lag from 1-bit (sign) correlation: the signs of the mean-removed
+// samples are packed 32 to a word, and agreement at each lag is counted
+// by XOR and popcount, so one word op covers 32 samples
+// The M4 has no popcount instruction, so bits are counted SWAR style
+// Uses the n range of findTdoaLag rounded down to whole words; length is
+// limited to 32 * TDOA_SIGN_MAX_WORDS samples
+// Returns false if the window is too short for one word at every lag
+// (length < 2 maxLag + 32); otherwise lag receives the lag with the most
+// sign agreements (ties go to the first)
+bool findSignTdoaLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                     uint16_t mask, int16_t maxLag, int16_t *lag)
+{
+    uint32_t aBits[TDOA_SIGN_MAX_WORDS];
+    uint32_t bBits[TDOA_SIGN_MAX_WORDS + 1];
+    int32_t sumA = 0, sumB = 0;
+    int16_t meanA, meanB;
+    uint32_t x;
+    uint16_t words, w, n, p;
+    uint8_t s;
+    int32_t agree, best = -1;
+    int16_t bestLag = 0;
+    int16_t d;
+
+    if (length > 32 * TDOA_SIGN_MAX_WORDS)
+        length = 32 * TDOA_SIGN_MAX_WORDS;
+    if (length < 2 * maxLag + 32)
+        return false;
+    words = (length - 2 * maxLag) / 32;
+
+    for (n = 0; n < length; n++)
+    {
+        sumA += a[(start + n) & mask];
+        sumB += b[(start + n) & mask];
+    }
+    meanA = sumA / length;
+    meanB = sumB / length;
+
+    // Bit j of aBits[w] is the sign of a[maxLag + 32w + j] and bit j of
+    // bBits[w] the sign of b[32w + j]; bBits has a zero word past the end
+    for (w = 0; w < words; w++)
+        aBits[w] = 0;
+    for (w = 0; w <= (length + 31) / 32; w++)
+        bBits[w] = 0;
+    for (n = 0; n < 32 * words; n++)
+        if (a[(start + maxLag + n) & mask] < meanA)
+            aBits[n >> 5] |= 1u << (n & 31);
+    for (n = 0; n < length; n++)
+        if (b[(start + n) & mask] < meanB)
+            bBits[n >> 5] |= 1u << (n & 31);
+
+    // a[maxLag + i] pairs with b[maxLag + d + i]
+    for (d = -maxLag; d <= maxLag; d++)
+    {
+        agree = 0;
+        p = (maxLag + d) >> 5;
+        s = (maxLag + d) & 31;
+        for (w = 0; w < words; w++)
+        {
+            x = bBits[p + w];
+            if (s != 0)
+                x = (x >> s) | (bBits[p + w + 1] << (32 - s));
+            x = ~(aBits[w] ^ x);
+            x = x - ((x >> 1) & 0x55555555);
+            x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+            x = (x + (x >> 4)) & 0x0F0F0F0F;
+            agree += (x * 0x01010101) >> 24;
+        }
+        if (agree > best)
+        {
+            best = agree;
+            bestLag = d;
+        }
+    }
+    *lag = bestLag;
+    return true;
+}
+
+// Offset (1/256 sample) of the vertex of the parabola through a correlation
+// peak and its two neighbors: (left - right) / 2(left - 2 peak + right)
+// Both terms are scaled down together to 24 bits first, so a 32-bit divide
+// does the work; returns 0 unless peak is a strict local maximum
+int16_t interpolateTdoaPeak(int64_t left, int64_t peak, int64_t right)
+{
+    int64_t num = left - right;
+    int64_t den = left - 2 * peak + right;
+    int64_t mag;
+
+    if (left > peak || right > peak || den >= 0)
+        return 0;
+    mag = -den;
+    while (mag >= (1 << 23))
+    {
+        mag >>= 1;
+        num >>= 1;
+        den >>= 1;
+    }
+    return (int32_t)num * 128 / (int32_t)den;
+}
+
+// Convert a lag in 1/256 samples to microseconds (rounded)
+int32_t getTdoaLagUs(int32_t lagQ8, uint32_t sampleRateHz)
+{
+    int64_t num = (int64_t)lagQ8 * 1000000;
+    int64_t den = (int64_t)sampleRateHz << 8;
+    if (num >= 0)
+        return (num + den / 2) / den;
+    return (num - den / 2) / den;
+}
@@ -0,0 +1,44 @@
+// TDOA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TDOA_H_
+#define TDOA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Speed of sound (mm/s) at about 20 C
+#define SPEED_OF_SOUND_MM 343000
+
+// Sign correlation packs up to 32 * TDOA_SIGN_MAX_WORDS samples per mic
+#define TDOA_SIGN_MAX_WORDS 32
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+int16_t getMaxTdoaLag(uint32_t spacingMm, uint32_t sampleRateHz);
+int16_t findTdoaLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                    uint16_t mask, int16_t maxLag, int32_t *lagQ8);
+int16_t findTdoaLagNear(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                        uint16_t mask, int16_t maxLag, int16_t center, int16_t radius,
+                        int32_t *lagQ8);
+bool findSignTdoaLag(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length,
+                     uint16_t mask, int16_t maxLag, int16_t *lag);
+int16_t interpolateTdoaPeak(int64_t left, int64_t peak, int64_t right);
+int32_t getTdoaLagUs(int32_t lagQ8, uint32_t sampleRateHz);
+
+#endif
@@ -0,0 +1,329 @@
+// ADC Simulator Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (models the TM4C123GH6PM ADC0/ADC1 and Timer 1A)
+// System Clock:    40 MHz (modeled)
+
+// Hardware configuration:
+// SS1 of both converters as adc0.c/adc1.c program it, Timer 1A trigger,
+// SS1 FIFOs drained by the simulated uDMA (dmasim.h), digital comparators
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmock.h"
+#include "dmasim.h"
+#include "adcsim.h"
+
+// ADC1 registers sit 4 KB above their ADC0 counterparts
+#define ADC1_OFFSET 0x1000
+
+#define FIFO_DEPTH 4
+#define MAX_STEPS 4
+
+// uDMA channels of ADC0 SS1 and ADC1 SS1
+#define DMA_CH_ADC0 15
+#define DMA_CH_ADC1 25
+
+// Timer clock period (ns)
+#define CLOCK_NS 25
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+ADC_SIM_SIGNAL simSignal;
+uint32_t simTimeNs = 0;
+
+// SS1 FIFO of each converter; tail is the next result read
+int16_t simFifo[2][FIFO_DEPTH];
+uint8_t simTail[2];
+uint8_t simCount[2];
+
+// Overflow flags not yet cleared, and whether the driver's next access to
+// OSTAT is the write that clears what it just read
+uint32_t simOverflow[2];
+bool simOstatRead[2];
+
+// Start of each step of the last sequence (ns)
+uint32_t simStepNs[2][MAX_STEPS];
+
+// Digital comparators: last band each one saw, whether a hysteresis mode
+// is latched high (until the low band), interrupts not yet cleared, and
+// whether the driver's next access to DCISC is the clearing write
+uint8_t simBand[2][8];
+bool simLatched[2][8];
+uint32_t simCompStatus[2];
+bool simDciscRead[2];
+
+// Device addresses of the hooked registers (naming them runs the hooks)
+uint32_t simStatAddr[2], simFifoAddr[2], simOstatAddr[2], simDciscAddr[2], simDcricAddr[2];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+uint32_t getSimReg(uint8_t adc, volatile uint32_t *adc0Reg)
+{
+    return *getMockReg(getMockRegAddr(adc0Reg) + adc * ADC1_OFFSET);
+}
+
+uint8_t getSimAdc(uint32_t addr)
+{
+    return addr == simStatAddr[1] || addr == simFifoAddr[1] || addr == simOstatAddr[1]
+        || addr == simDciscAddr[1] || addr == simDcricAddr[1];
+}
+
+// SSFSTAT1 shows the FIFO pointers and the full/empty flags
+void updateSimFifoStatus(uint32_t addr)
+{
+    uint8_t adc = getSimAdc(addr);
+    uint8_t head = (simTail[adc] + simCount[adc]) % FIFO_DEPTH;
+    uint32_t stat = ((uint32_t)head << ADC_SSFSTAT1_HPTR_S) | ((uint32_t)simTail[adc] << ADC_SSFSTAT1_TPTR_S);
+    if (simCount[adc] == 0)
+        stat |= ADC_SSFSTAT1_EMPTY;
+    if (simCount[adc] == FIFO_DEPTH)
+        stat |= ADC_SSFSTAT1_FULL;
+    *getMockReg(addr) = stat;
+}
+
+// Naming SSFIFO1 pops the oldest result; an empty FIFO reads as the last one
+void popSimFifo(uint32_t addr)
+{
+    uint8_t adc = getSimAdc(addr);
+    if (simCount[adc] == 0)
+        return;
+    *getMockReg(addr) = (uint16_t)simFifo[adc][simTail[adc]];
+    simTail[adc] = (simTail[adc] + 1) % FIFO_DEPTH;
+    simCount[adc]--;
+}
+
+// OSTAT is write-1-to-clear; the drivers only read it and then write back
+// the bits they saw, so accesses alternate between the two
+void updateSimOverflow(uint32_t addr)
+{
+    uint8_t adc = getSimAdc(addr);
+    uint32_t *reg = getMockReg(addr);
+    if (simOstatRead[adc])
+        simOverflow[adc] &= ~*reg;
+    simOstatRead[adc] = !simOstatRead[adc];
+    *reg = simOverflow[adc];
+}
+
+// DCISC is write-1-to-clear and handled like OSTAT
+void updateSimCompStatus(uint32_t addr)
+{
+    uint8_t adc = getSimAdc(addr);
+    uint32_t *reg = getMockReg(addr);
+    if (simDciscRead[adc])
+        simCompStatus[adc] &= ~*reg;
+    simDciscRead[adc] = !simDciscRead[adc];
+    *reg = simCompStatus[adc];
+}
+
+// DCRIC is only written: each bit set since the last access resets that
+// comparator to its idle state
+void resetSimComparators(uint32_t addr)
+{
+    uint8_t adc = getSimAdc(addr);
+    uint32_t *reg = getMockReg(addr);
+    uint8_t comp;
+    for (comp = 0; comp < 8; comp++)
+        if (*reg & (ADC_DCRIC_DCINT0 << comp))
+        {
+            simBand[adc][comp] = 0;
+            simLatched[adc][comp] = false;
+        }
+    *reg = 0;
+}
+
+// Start both converters idle with empty FIFOs, inputs given by signal,
+// and the uDMA model with every channel disabled
+void initAdcSim(ADC_SIM_SIGNAL signal)
+{
+    uint8_t adc, comp;
+    initDmaSim();
+    simSignal = signal;
+    simTimeNs = 0;
+    for (adc = 0; adc < 2; adc++)
+    {
+        simStatAddr[adc] = getMockRegAddr(&ADC0_SSFSTAT1_R) + adc * ADC1_OFFSET;
+        simFifoAddr[adc] = getMockRegAddr(&ADC0_SSFIFO1_R) + adc * ADC1_OFFSET;
+        simOstatAddr[adc] = getMockRegAddr(&ADC0_OSTAT_R) + adc * ADC1_OFFSET;
+        simDciscAddr[adc] = getMockRegAddr(&ADC0_DCISC_R) + adc * ADC1_OFFSET;
+        simDcricAddr[adc] = getMockRegAddr(&ADC0_DCRIC_R) + adc * ADC1_OFFSET;
+    }
+    for (adc = 0; adc < 2; adc++)
+    {
+        simTail[adc] = 0;
+        simCount[adc] = 0;
+        simOverflow[adc] = 0;
+        simOstatRead[adc] = false;
+        simCompStatus[adc] = 0;
+        simDciscRead[adc] = false;
+        for (comp = 0; comp < 8; comp++)
+        {
+            simBand[adc][comp] = 0;
+            simLatched[adc][comp] = false;
+        }
+        *getMockReg(simOstatAddr[adc]) = 0;
+        *getMockReg(simDciscAddr[adc]) = 0;
+        *getMockReg(simDcricAddr[adc]) = 0;
+        setMockRegHook(simStatAddr[adc], updateSimFifoStatus);
+        setMockRegHook(simFifoAddr[adc], popSimFifo);
+        setMockRegHook(simOstatAddr[adc], updateSimOverflow);
+        setMockRegHook(simDciscAddr[adc], updateSimCompStatus);
+        setMockRegHook(simDcricAddr[adc], resetSimComparators);
+    }
+}
+
+// Queue one SS1 result; a full FIFO drops it and flags the overflow
+// The uDMA channel, when enabled, takes results as soon as they arrive
+void pushAdcSimFifo(uint8_t adc, int16_t result)
+{
+    uint8_t ch = adc ? DMA_CH_ADC1 : DMA_CH_ADC0;
+    if (simCount[adc] == FIFO_DEPTH)
+        simOverflow[adc] |= ADC_OSTAT_OV1;
+    else
+    {
+        simFifo[adc][(simTail[adc] + simCount[adc]) % FIFO_DEPTH] = result;
+        simCount[adc]++;
+    }
+    while (simCount[adc] > 0 && requestDmaSim(ch, simFifo[adc][simTail[adc]]))
+    {
+        simTail[adc] = (simTail[adc] + 1) % FIFO_DEPTH;
+        simCount[adc]--;
+    }
+    if (!simOstatRead[adc])
+        *getMockReg(simOstatAddr[adc]) = simOverflow[adc];
+}
+
+// Feed one result to digital comparator comp of converter adc
+// Bands: low below COMP0, mid from COMP0 up to COMP1, high from COMP1 up
+// Interrupt modes (CIM) for the band in CIC: always while in it, once on
+// entering it; the hysteresis modes latch on entering the high (or low)
+// band and release only in the opposite band, firing while latched or
+// once per latch
+void compareAdcSim(uint8_t adc, uint8_t comp, int16_t x)
+{
+    uint32_t ctl = getSimReg(adc, &ADC0_DCCTL0_R + comp);
+    uint32_t cmp = getSimReg(adc, &ADC0_DCCMP0_R + comp);
+    uint16_t low = (cmp & ADC_DCCMP0_COMP0_M) >> ADC_DCCMP0_COMP0_S;
+    uint16_t high = (cmp & ADC_DCCMP0_COMP1_M) >> ADC_DCCMP0_COMP1_S;
+    uint8_t want = (ctl & ADC_DCCTL0_CIC_M) >> 2;
+    uint8_t band = x < low ? 0 : (x < high ? 1 : 3);
+    uint8_t last;
+    bool fire = false;
+
+    //apply a reset written since DCRIC was last named
+    resetSimComparators(simDcricAddr[adc]);
+    last = simBand[adc][comp];
+
+    switch (ctl & ADC_DCCTL0_CIM_M)
+    {
+        case ADC_DCCTL0_CIM_ALWAYS:
+            fire = band == want;
+            break;
+        case ADC_DCCTL0_CIM_ONCE:
+            fire = band == want && last != want;
+            break;
+        default:
+            //hysteresis: the latch sets in the wanted band and clears in
+            //the opposite one (mid has no hysteresis and never latches)
+            if (want != 1 && band == want && !simLatched[adc][comp])
+            {
+                simLatched[adc][comp] = true;
+                fire = true;
+            }
+            else if (simLatched[adc][comp] && band == 3 - want)
+                simLatched[adc][comp] = false;
+            else if ((ctl & ADC_DCCTL0_CIM_M) == ADC_DCCTL0_CIM_HALWAYS)
+                fire = simLatched[adc][comp];
+            break;
+    }
+    simBand[adc][comp] = band;
+    if (fire && (ctl & ADC_DCCTL0_CIE))
+        simCompStatus[adc] |= ADC_DCISC_DCINT0 << comp;
+    if (!simDciscRead[adc])
+        *getMockReg(simDciscAddr[adc]) = simCompStatus[adc];
+}
+
+// Run SS1 of converter adc (0 or 1) once, started at timeNs: each step
+// converts its SSMUX1 input 2^SAC times a conversion period (PC) apart and
+// averages them; steps run back to back up to the END step
+void triggerAdcSim(uint8_t adc, uint32_t timeNs)
+{
+    uint32_t mux = getSimReg(adc, &ADC0_SSMUX1_R);
+    uint32_t ctl = getSimReg(adc, &ADC0_SSCTL1_R);
+    uint32_t op = getSimReg(adc, &ADC0_SSOP1_R);
+    uint32_t dc = getSimReg(adc, &ADC0_SSDC1_R);
+    uint8_t log2Avg = getSimReg(adc, &ADC0_SAC_R) & 7;
+    uint32_t periodNs, t = timeNs;
+    int32_t sum;
+    uint8_t step, ain;
+    uint16_t i;
+
+    if (!(getSimReg(adc, &ADC0_ACTSS_R) & ADC_ACTSS_ASEN1))
+        return;
+    switch (getSimReg(adc, &ADC0_PC_R) & ADC_PC_SR_M)
+    {
+        case ADC_PC_SR_125K: periodNs = 8000; break;
+        case ADC_PC_SR_250K: periodNs = 4000; break;
+        case ADC_PC_SR_500K: periodNs = 2000; break;
+        default:             periodNs = 1000; break;
+    }
+
+    for (step = 0; step < MAX_STEPS; step++)
+    {
+        ain = (mux >> (step * 4)) & 0xF;
+        simStepNs[adc][step] = t;
+        sum = 0;
+        for (i = 0; i < (1u << log2Avg); i++)
+        {
+            sum += simSignal(ain, t);
+            t += periodNs;
+        }
+        //steps sent to a digital comparator do not reach the FIFO
+        if (op & (ADC_SSOP1_S0DCOP << (step * 4)))
+            compareAdcSim(adc, (dc >> (step * 4)) & ADC_SSDC1_S0DCSEL_M, sum >> log2Avg);
+        else
+            pushAdcSimFifo(adc, sum >> log2Avg);
+        if (ctl & (ADC_SSCTL1_END0 << (step * 4)))
+            break;
+    }
+}
+
+// Advance to the next Timer 1A timeout (TAILR + 1 clocks) and start every
+// converter whose SS1 takes the timer trigger; returns the time (ns)
+// The timer only runs, and only triggers, as TIMER1_CTL enables it
+uint32_t tickAdcSimTimer(void)
+{
+    uint32_t ctl = TIMER1_CTL_R;
+    uint8_t adc;
+    if (!(ctl & TIMER_CTL_TAEN))
+        return simTimeNs;
+    simTimeNs += (TIMER1_TAILR_R + 1) * CLOCK_NS;
+    if (ctl & TIMER_CTL_TAOTE)
+        for (adc = 0; adc < 2; adc++)
+            if ((getSimReg(adc, &ADC0_EMUX_R) & ADC_EMUX_EM1_M) == ADC_EMUX_EM1_TIMER)
+                triggerAdcSim(adc, simTimeNs);
+    return simTimeNs;
+}
+
+// Start of a step in the last sequence of a converter (ns)
+uint32_t getAdcSimStepNs(uint8_t adc, uint8_t step)
+{
+    return simStepNs[adc][step];
+}
+
+uint8_t getAdcSimFifoCount(uint8_t adc)
+{
+    return simCount[adc];
+}
@@ -0,0 +1,40 @@
+// ADC Simulator Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (models the TM4C123GH6PM ADC0/ADC1 and Timer 1A)
+// System Clock:    40 MHz (modeled)
+
+// Hardware configuration:
+// SS1 of both converters as adc0.c/adc1.c program it, Timer 1A trigger,
+// SS1 FIFOs drained by the simulated uDMA (dmasim.h), digital comparators
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef ADCSIM_H_
+#define ADCSIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Input voltage (counts) of analog input ain at a time in ns
+typedef int16_t (*ADC_SIM_SIGNAL)(uint8_t ain, uint32_t timeNs);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initAdcSim(ADC_SIM_SIGNAL signal);
+void compareAdcSim(uint8_t adc, uint8_t comp, int16_t x);
+void triggerAdcSim(uint8_t adc, uint32_t timeNs);
+uint32_t tickAdcSimTimer(void);
+uint32_t getAdcSimStepNs(uint8_t adc, uint8_t step);
+uint8_t getAdcSimFifoCount(uint8_t adc);
+void pushAdcSimFifo(uint8_t adc, int16_t result);
+
+#endif
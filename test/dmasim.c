@@ -0,0 +1,138 @@
+// uDMA Simulator Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (models the TM4C123GH6PM uDMA controller)
+// System Clock:    -
+
+// Hardware configuration:
+// Peripheral-to-memory ping-pong channels set up by udma.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "regmock.h"
+#include "dmasim.h"
+
+// Control structure layout, as in udma.c
+#define DST_END  1
+#define CTL      2
+#define ALT      128
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// The driver's control table; the destination end pointers in it are 32-bit,
+// so blocks must be static (the tests link without PIE to keep them low)
+extern volatile uint32_t dmaTable[256];
+
+// Channel enables and the structure (0 primary, 1 alternate) each channel
+// is working on, behind the write-1-to-set/clear registers
+uint32_t simEnabled = 0;
+uint8_t simAlt[32];
+
+// Device addresses of the registers the model follows
+uint32_t simSetAddr, simClrAddr, simAltClrAddr, simChisAddr;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Apply what the driver wrote to ENASET, ENACLR and ALTCLR since the last
+// call; these registers are only ever written with the bits to change
+// (ENASET is also read, as the enables), so each is reloaded afterwards
+// with the value a read would return
+void syncDmaSim(uint32_t addr)
+{
+    uint32_t *set = getMockReg(simSetAddr);
+    uint32_t *clr = getMockReg(simClrAddr);
+    uint32_t *altClr = getMockReg(simAltClrAddr);
+    uint8_t ch;
+    (void)addr;
+
+    simEnabled |= *set;
+    simEnabled &= ~*clr;
+    for (ch = 0; ch < 32; ch++)
+        if (*altClr & (1u << ch))
+            simAlt[ch] = 0;
+    *set = simEnabled;
+    *clr = 0;
+    *altClr = 0;
+}
+
+// Start with every channel disabled and follow the driver's writes
+void initDmaSim(void)
+{
+    uint8_t ch;
+    simSetAddr = getMockRegAddr(&UDMA_ENASET_R);
+    simClrAddr = getMockRegAddr(&UDMA_ENACLR_R);
+    simAltClrAddr = getMockRegAddr(&UDMA_ALTCLR_R);
+    simChisAddr = getMockRegAddr(&UDMA_CHIS_R);
+    simEnabled = 0;
+    for (ch = 0; ch < 32; ch++)
+        simAlt[ch] = 0;
+    *getMockReg(simSetAddr) = 0;
+    *getMockReg(simClrAddr) = 0;
+    *getMockReg(simAltClrAddr) = 0;
+    setMockRegHook(simSetAddr, syncDmaSim);
+    setMockRegHook(simClrAddr, syncDmaSim);
+    setMockRegHook(simAltClrAddr, syncDmaSim);
+}
+
+bool isDmaSimEnabled(uint8_t channel)
+{
+    syncDmaSim(0);
+    return (simEnabled & (1u << channel)) != 0;
+}
+
+// One peripheral request: move item into the block of the structure in use
+// When its count runs out the structure stops, the channel interrupt is
+// raised and the other structure takes over; if that one has not been
+// re-armed the controller disables the channel
+// Returns false if the channel was disabled and the item was left behind
+bool requestDmaSim(uint8_t channel, int16_t item)
+{
+    uint16_t i;
+    uint32_t ctl, left;
+    int16_t *end;
+
+    syncDmaSim(0);
+    if (!(simEnabled & (1u << channel)))
+        return false;
+    i = channel * 4 + (simAlt[channel] ? ALT : 0);
+    ctl = dmaTable[i + CTL];
+    if ((ctl & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_PINGPONG)
+    {
+        simEnabled &= ~(1u << channel);
+        *getMockReg(simSetAddr) = simEnabled;
+        return false;
+    }
+
+    left = ((ctl & UDMA_CHCTL_XFERSIZE_M) >> UDMA_CHCTL_XFERSIZE_S) + 1;
+    end = (int16_t *)(uintptr_t)dmaTable[i + DST_END];
+    end[1 - (int32_t)left] = item;
+    ctl &= ~UDMA_CHCTL_XFERSIZE_M;
+    if (--left > 0)
+    {
+        dmaTable[i + CTL] = ctl | ((left - 1) << UDMA_CHCTL_XFERSIZE_S);
+        return true;
+    }
+
+    dmaTable[i + CTL] = ctl & ~UDMA_CHCTL_XFERMODE_M;
+    *getMockReg(simChisAddr) |= 1u << channel;
+    simAlt[channel] ^= 1;
+    i = channel * 4 + (simAlt[channel] ? ALT : 0);
+    if ((dmaTable[i + CTL] & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_PINGPONG)
+    {
+        simEnabled &= ~(1u << channel);
+        *getMockReg(simSetAddr) = simEnabled;
+    }
+    return true;
+}
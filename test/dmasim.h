@@ -0,0 +1,32 @@
+// uDMA Simulator Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (models the TM4C123GH6PM uDMA controller)
+// System Clock:    -
+
+// Hardware configuration:
+// Peripheral-to-memory ping-pong channels set up by udma.c
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef DMASIM_H_
+#define DMASIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initDmaSim(void);
+bool isDmaSimEnabled(uint8_t channel);
+bool requestDmaSim(uint8_t channel, int16_t item);
+
+#endif
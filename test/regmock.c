@@ -0,0 +1,103 @@
+// Register Mock Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (stands in for the TM4C123GH6PM)
+// System Clock:    -
+
+// Hardware configuration:
+// Peripheral (0x40000000) and core (0xE0000000) register spaces as memory
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "regmock.h"
+
+// Each space is 1 MB; drivers index register arrays (SSMUXn, DCCTLn) from
+// one register, so the space must be contiguous
+#define SPACE_SIZE 0x100000
+#define PERIPHERAL_BASE 0x40000000
+#define CORE_BASE 0xE0000000
+
+#define MAX_HOOKS 16
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+uint32_t peripheralRegs[SPACE_SIZE / 4];
+uint32_t coreRegs[SPACE_SIZE / 4];
+
+uint32_t hookAddr[MAX_HOOKS];
+REG_HOOK hookFn[MAX_HOOKS];
+uint8_t hookCount = 0;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Storage of a register, without calling its hook; any address outside
+// the two spaces is a driver bug, so the test stops there
+uint32_t *getMockReg(uint32_t addr)
+{
+    uint8_t *space;
+    if ((addr & ~(SPACE_SIZE - 1)) == PERIPHERAL_BASE)
+        space = (uint8_t *)peripheralRegs;
+    else if ((addr & ~(SPACE_SIZE - 1)) == CORE_BASE)
+        space = (uint8_t *)coreRegs;
+    else
+    {
+        fprintf(stderr, "unmapped register 0x%08X\n", addr);
+        abort();
+    }
+    return (uint32_t *)(space + (addr & (SPACE_SIZE - 1)));
+}
+
+// Device address of a register named in a test, e.g. &UDMA_ENASET_R
+uint32_t getMockRegAddr(volatile void *reg)
+{
+    uint8_t *p = (uint8_t *)reg;
+    if (p >= (uint8_t *)peripheralRegs && p < (uint8_t *)peripheralRegs + SPACE_SIZE)
+        return PERIPHERAL_BASE + (p - (uint8_t *)peripheralRegs);
+    if (p >= (uint8_t *)coreRegs && p < (uint8_t *)coreRegs + SPACE_SIZE)
+        return CORE_BASE + (p - (uint8_t *)coreRegs);
+    abort();
+}
+
+volatile void *mockReg(uint32_t addr)
+{
+    uint8_t i;
+    for (i = 0; i < hookCount; i++)
+        if (hookAddr[i] == addr)
+            hookFn[i](addr);
+    return getMockReg(addr);
+}
+
+// Call hook whenever the register at addr is named (one hook per address)
+void setMockRegHook(uint32_t addr, REG_HOOK hook)
+{
+    uint8_t i;
+    for (i = 0; i < hookCount && hookAddr[i] != addr; i++);
+    if (i == MAX_HOOKS)
+        abort();
+    hookAddr[i] = addr;
+    hookFn[i] = hook;
+    if (i == hookCount)
+        hookCount++;
+}
+
+// Zero every register and drop the hooks
+void resetMockRegs(void)
+{
+    memset(peripheralRegs, 0, sizeof(peripheralRegs));
+    memset(coreRegs, 0, sizeof(coreRegs));
+    hookCount = 0;
+}
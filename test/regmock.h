@@ -0,0 +1,41 @@
+// Register Mock Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       - (stands in for the TM4C123GH6PM)
+// System Clock:    -
+
+// Hardware configuration:
+// The generated build/tm4c123gh6pm.h maps every register to mockReg(address),
+// so the drivers build unchanged and run against plain memory
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef REGMOCK_H_
+#define REGMOCK_H_
+
+#include <stdint.h>
+
+// The CCS intrinsic only waits for the peripheral clock
+#define _delay_cycles(n) ((void)(n))
+
+// Called with the register address each time a driver names that register
+// (read, write or &), before the access; used to model FIFOs and status
+typedef void (*REG_HOOK)(uint32_t addr);
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+volatile void *mockReg(uint32_t addr);
+uint32_t *getMockReg(uint32_t addr);
+uint32_t getMockRegAddr(volatile void *reg);
+void setMockRegHook(uint32_t addr, REG_HOOK hook);
+void resetMockRegs(void);
+
+#endif
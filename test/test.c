@@ -0,0 +1,74 @@
+// Host Test Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#include "test.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+uint32_t testChecks = 0;
+uint32_t testFailures = 0;
+uint32_t testSeed = 0x12345678;
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool checkTest(bool ok, const char *expr, const char *file, int line)
+{
+    testChecks++;
+    if (!ok)
+    {
+        testFailures++;
+        printf("%s:%d: check failed: %s\n", file, line, expr);
+    }
+    return ok;
+}
+
+// Print the summary; returns the exit code of the test program
+int finishTest(const char *name)
+{
+    printf("%s: %u checks, %u failed\n", name, testChecks, testFailures);
+    return testFailures != 0;
+}
+
+// Repeatable pseudo-random numbers (xorshift32), same sequence every run
+uint32_t getTestRandom(void)
+{
+    testSeed ^= testSeed << 13;
+    testSeed ^= testSeed >> 17;
+    testSeed ^= testSeed << 5;
+    return testSeed;
+}
+
+// Uniform noise in -amplitude .. amplitude
+int16_t getTestNoise(int16_t amplitude)
+{
+    return (int32_t)(getTestRandom() % (2 * (uint32_t)amplitude + 1)) - amplitude;
+}
+
+// Monotonic time in ns, for the host benchmarks
+uint64_t getTestNs(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
@@ -0,0 +1,36 @@
+// Host Test Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: host build of the unit tests
+// Target uC:       -
+// System Clock:    -
+
+// Hardware configuration: -
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Record one check; a failure prints the expression and where it is
+#define CHECK(c) checkTest((c), #c, __FILE__, __LINE__)
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+bool checkTest(bool ok, const char *expr, const char *file, int line);
+int finishTest(const char *name);
+uint32_t getTestRandom(void);
+int16_t getTestNoise(int16_t amplitude);
+uint64_t getTestNs(void);
+
+#endif
@@ -0,0 +1,149 @@
+// ADC0 SS1 FIFO block read tests against the simulated FIFO
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "adc0.h"
+#include "adcsim.h"
+
+// Inputs read back as their AIN number times 100 plus the sequence time in us
+int16_t ainSignal(uint8_t ain, uint32_t timeNs)
+{
+    return ain * 100 + timeNs / 1000;
+}
+
+void startAdc0()
+{
+    resetMockRegs();
+    initAdcSim(ainSignal);
+    initAdc0Ss1();
+}
+
+// The count from the SSFSTAT head and tail pointers is right for every fill
+// level at every tail position, including a full FIFO (head == tail)
+void testFifoCount()
+{
+    uint8_t tail, count, i;
+    int16_t x;
+    bool ok = true;
+
+    startAdc0();
+    for (tail = 0; tail < 4; tail++)
+    {
+        for (count = 0; count <= 4; count++)
+        {
+            for (i = 0; i < count; i++)
+                pushAdcSimFifo(0, i);
+            ok &= getAdc0Ss1FifoCount() == count;
+            for (i = 0; i < count; i++)
+                x = ADC0_SSFIFO1_R;
+            ok &= getAdc0Ss1FifoCount() == 0;
+        }
+        //move the tail on by one
+        pushAdcSimFifo(0, 0);
+        x = ADC0_SSFIFO1_R;
+    }
+    (void)x;
+    CHECK(ok);
+}
+
+// A block read takes what is there, up to max, oldest first, and never
+// reads an empty FIFO
+void testBlockRead()
+{
+    int16_t dst[8];
+    uint8_t i;
+
+    startAdc0();
+    CHECK(readAdc0Ss1Block(dst, 8) == 0);
+    for (i = 0; i < 3; i++)
+        pushAdcSimFifo(0, 10 + i);
+    CHECK(readAdc0Ss1Block(dst, 2) == 2);
+    CHECK(dst[0] == 10 && dst[1] == 11);
+    CHECK(getAdcSimFifoCount(0) == 1);
+    for (i = 0; i < 3; i++)
+        pushAdcSimFifo(0, 13 + i);
+    CHECK(readAdc0Ss1Block(dst, 8) == 4);
+    CHECK(dst[0] == 12 && dst[1] == 13 && dst[2] == 14 && dst[3] == 15);
+    CHECK(getAdcSimFifoCount(0) == 0);
+    CHECK(!updateAdc0LossCounters());
+}
+
+// Deinterleaving takes whole sequences into one array per step and leaves
+// a partial sequence for the next call
+void testDeinterleaved()
+{
+    static const uint8_t ain[2] = {1, 4};
+    int16_t mic1[4], mic3[4];
+    int16_t *dst[2] = {mic1, mic3};
+
+    startAdc0();
+    CHECK(setAdc0Ss1Sequence(ain, 2));
+    triggerAdcSim(0, 10000);
+    triggerAdcSim(0, 20000);
+    CHECK(readAdc0Ss1Deinterleaved(dst, 2, 4) == 2);
+    CHECK(mic1[0] == 110 && mic3[0] == 411);
+    CHECK(mic1[1] == 120 && mic3[1] == 421);
+
+    triggerAdcSim(0, 30000);
+    pushAdcSimFifo(0, 999);
+    CHECK(readAdc0Ss1Deinterleaved(dst, 2, 4) == 1);
+    CHECK(mic1[0] == 130 && mic3[0] == 431);
+    CHECK(getAdcSimFifoCount(0) == 1);
+
+    //maxSequences limits the read
+    startAdc0();
+    setAdc0Ss1Sequence(ain, 2);
+    triggerAdcSim(0, 10000);
+    triggerAdcSim(0, 20000);
+    CHECK(readAdc0Ss1Deinterleaved(dst, 2, 1) == 1);
+    CHECK(getAdcSimFifoCount(0) == 2);
+}
+
+// A sequence arriving on a full FIFO is lost and counted once
+void testOverflow()
+{
+    static const uint8_t ain[4] = {1, 4, 1, 4};
+    int16_t dst[4];
+
+    startAdc0();
+    setAdc0Ss1Sequence(ain, 4);
+    triggerAdcSim(0, 10000);
+    CHECK(!updateAdc0LossCounters());
+    triggerAdcSim(0, 20000);
+    CHECK(getAdcSimFifoCount(0) == 4);
+    CHECK(updateAdc0LossCounters());
+    CHECK(getAdc0OverflowCount(1) == 1);
+    CHECK(!updateAdc0LossCounters());
+    CHECK(getAdc0OverflowCount(1) == 1);
+
+    //the first sequence survives intact
+    CHECK(readAdc0Ss1Block(dst, 4) == 4);
+    CHECK(dst[0] == 110 && dst[1] == 411 && dst[2] == 112 && dst[3] == 413);
+}
+
+// Interrupt on every n-th step and always on the last one, END on the last
+void testInterruptEvery()
+{
+    startAdc0();
+    setAdc0Ss1InterruptEvery(1, 4);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_IE0 | ADC_SSCTL1_IE1 | ADC_SSCTL1_IE2 | ADC_SSCTL1_IE3
+                            | ADC_SSCTL1_END3));
+    setAdc0Ss1InterruptEvery(2, 4);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_IE1 | ADC_SSCTL1_IE3 | ADC_SSCTL1_END3));
+    setAdc0Ss1InterruptEvery(3, 4);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_IE2 | ADC_SSCTL1_IE3 | ADC_SSCTL1_END3));
+    setAdc0Ss1InterruptEvery(0, 3);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_IE2 | ADC_SSCTL1_END2));
+    CHECK(ADC0_ACTSS_R & ADC_ACTSS_ASEN1);
+}
+
+int main(void)
+{
+    testFifoCount();
+    testBlockRead();
+    testDeinterleaved();
+    testOverflow();
+    testInterruptEvery();
+    return finishTest("adc0");
+}
@@ -0,0 +1,134 @@
+// ADC0/ADC1 synchronized sampling tests against the simulated converters
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "timer1.h"
+#include "adc0.h"
+#include "adc1.h"
+#include "dmasim.h"
+#include "adcsim.h"
+
+#define SEQ_RATE 20000
+#define SEQ_NS (1000000000 / SEQ_RATE)
+#define BLOCK_SEQS 8
+
+// MIC1 and MIC3 to the FIFO, then again to comparators 0 and 1; MIC2 on ADC1
+const uint8_t adc0Ain[4] = {1, 4, 1, 4};
+const uint8_t adc1Ain[1] = {2};
+
+int16_t ping0[BLOCK_SEQS * 2], pong0[BLOCK_SEQS * 2];
+int16_t ping1[BLOCK_SEQS], pong1[BLOCK_SEQS];
+
+// Each input reads its AIN number in the top bits and the index of the
+// sequence the conversion falls in below, so a result tells where it came from
+int16_t tagSignal(uint8_t ain, uint32_t timeNs)
+{
+    return (ain << 8) | ((timeNs / SEQ_NS) & 0xFF);
+}
+
+// Program both converters the way main() does, timer stopped
+void startConverters(uint32_t sps, uint8_t log2Avg, bool adc1Timed)
+{
+    resetMockRegs();
+    initAdcSim(tagSignal);
+    initAdc0Ss1Timed(SEQ_RATE);
+    stopTimer1();
+    initAdc1Ss1();
+    if (adc1Timed)
+        selectAdc1Ss1TimerTrigger();
+    setAdc0Ss1Sequence(adc0Ain, 4);
+    setAdc0Ss1StepComparator(2, 0);
+    setAdc0Ss1StepComparator(3, 1);
+    setAdc1Ss1Sequence(adc1Ain, 1);
+    setAdc0Ss1Log2AverageCount(log2Avg);
+    setAdc1Ss1Log2AverageCount(log2Avg);
+    initAdc0Ss1Dma(ping0, pong0, BLOCK_SEQS * 2);
+    initAdc1Ss1Dma(ping1, pong1, BLOCK_SEQS);
+    setAdc0ConversionRate(sps);
+    setAdc1ConversionRate(sps);
+}
+
+// For every converter rate and averaging that fits a sequence period, MIC1
+// and MIC2 start converting on the same edge, MIC3 one step later as
+// getAdc0Ss1StepNs() reports, and the ADC0 and ADC1 blocks handed out
+// together hold the same sequences
+void testSkew()
+{
+    static const uint32_t rates[4] = {125000, 250000, 500000, 1000000};
+    int16_t *block0, *block1;
+    uint32_t t, stepNs, seq = 0;
+    uint16_t i, n;
+    uint8_t r, log2Avg;
+    bool sync = true, skew = true, paired = true, blocks = true;
+
+    for (r = 0; r < 4; r++)
+        for (log2Avg = 0; log2Avg <= 2; log2Avg++)
+        {
+            startConverters(rates[r], log2Avg, true);
+            stepNs = getAdc0Ss1StepNs();
+            if (4 * stepNs > SEQ_NS)
+                continue;
+            startTimer1();
+            for (n = 0; n < 4 * BLOCK_SEQS; n++)
+            {
+                t = tickAdcSimTimer();
+                sync &= getAdcSimStepNs(1, 0) == t && getAdcSimStepNs(0, 0) == t;
+                skew &= getAdcSimStepNs(0, 1) - getAdcSimStepNs(0, 0) == stepNs;
+                if (n % BLOCK_SEQS != BLOCK_SEQS - 1)
+                    continue;
+                block0 = getAdc0Ss1DmaBlock();
+                block1 = getAdc1Ss1DmaBlock();
+                blocks &= block0 != 0 && block1 != 0;
+                if (block0 == 0 || block1 == 0)
+                    continue;
+                for (i = 0; i < BLOCK_SEQS; i++)
+                {
+                    seq = (t / SEQ_NS - (BLOCK_SEQS - 1) + i) & 0xFF;
+                    paired &= block0[2 * i] == (int16_t)((1 << 8) | seq)
+                           && block1[i] == (int16_t)((2 << 8) | seq)
+                           && block0[2 * i + 1] == (int16_t)((4 << 8) | seq);
+                }
+            }
+            CHECK(getAdc0Ss1DmaStallCount() == 0 && getAdc1Ss1DmaStallCount() == 0);
+        }
+    CHECK(sync);
+    CHECK(skew);
+    CHECK(paired);
+    CHECK(blocks);
+}
+
+// The step time follows the converter rate and the averaging
+void testStepNs()
+{
+    startConverters(1000000, 0, true);
+    CHECK(getAdc0Ss1StepNs() == 1000);
+    setAdc0ConversionRate(125000);
+    CHECK(getAdc0Ss1StepNs() == 8000);
+    setAdc0Ss1Log2AverageCount(2);
+    CHECK(getAdc0Ss1StepNs() == 32000);
+    CHECK(!setAdc0ConversionRate(100000));
+    CHECK(getAdc0Ss1StepNs() == 32000);
+}
+
+// ADC1 left on the processor trigger never converts, so its blocks never
+// come; the ISR then drops ADC0 blocks as ADC1 timeouts
+void testUnsynced()
+{
+    uint16_t n;
+    startConverters(1000000, 0, false);
+    startTimer1();
+    for (n = 0; n < 2 * BLOCK_SEQS; n++)
+        tickAdcSimTimer();
+    CHECK(getAdc0Ss1DmaBlock() != 0);
+    CHECK(getAdc1Ss1DmaBlock() == 0);
+    CHECK(getAdcSimFifoCount(1) == 0);
+}
+
+int main(void)
+{
+    testSkew();
+    testStepNs();
+    testUnsynced();
+    return finishTest("adc1");
+}
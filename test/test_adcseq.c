@@ -0,0 +1,135 @@
+// ADC sequence encoder tests, exhaustive over step counts and settings,
+// and the ADC0/ADC1 sequence setup that uses them
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "adcseq.h"
+#include "adc0.h"
+#include "adc1.h"
+
+// SSCTLn built one step at a time from the datasheet bits
+uint32_t getCtlRef(uint8_t count, uint8_t every)
+{
+    uint32_t ctl = 0, step;
+    uint8_t i;
+    for (i = 0; i < count; i++)
+    {
+        step = 0;
+        if (i == count - 1)
+            step = ADC_SSCTL0_END0 | ADC_SSCTL0_IE0;
+        if (every > 0 && (i + 1) % every == 0)
+            step |= ADC_SSCTL0_IE0;
+        ctl |= step << (i * 4);
+    }
+    return ctl;
+}
+
+void testDepth()
+{
+    CHECK(getAdcSequencerDepth(0) == 8);
+    CHECK(getAdcSequencerDepth(1) == 4);
+    CHECK(getAdcSequencerDepth(2) == 4);
+    CHECK(getAdcSequencerDepth(3) == 1);
+    CHECK(getAdcSequencerDepth(4) == 0);
+}
+
+// Every AIN in every step position of every list length lands in its own
+// nibble, and steps past count (or past 8) are never encoded
+void testMux()
+{
+    uint8_t ain[10];
+    uint8_t count, pos, value, i;
+    uint16_t n;
+    uint32_t ref;
+    bool ok = true, random = true;
+
+    for (count = 1; count <= 8; count++)
+        for (pos = 0; pos < count; pos++)
+            for (value = 0; value < 16; value++)
+            {
+                for (i = 0; i < 10; i++)
+                    ain[i] = 0;
+                ain[pos] = value;
+                ok &= encodeAdcSsMux(ain, count) == (uint32_t)value << (pos * 4);
+            }
+    CHECK(ok);
+
+    //random lists with repeats, including counts over the deepest FIFO
+    for (n = 0; n < 10000; n++)
+    {
+        count = getTestRandom() % 11;
+        ref = 0;
+        for (i = 0; i < 10; i++)
+        {
+            ain[i] = getTestRandom() % 12;
+            if (i < count && i < 8)
+                ref |= (uint32_t)ain[i] << (i * 4);
+        }
+        random &= encodeAdcSsMux(ain, count) == ref;
+    }
+    CHECK(random);
+    CHECK(encodeAdcSsMux(ain, 0) == 0);
+}
+
+// Every count and interrupt spacing matches the step-by-step reference;
+// counts over 8 encode as 8
+void testCtl()
+{
+    uint8_t count, every;
+    bool ok = true, clamped = true;
+
+    for (count = 0; count <= 8; count++)
+        for (every = 0; every <= 10; every++)
+            ok &= encodeAdcSsCtl(count, every) == getCtlRef(count, every);
+    for (count = 9; count < 255; count++)
+        for (every = 0; every <= 10; every++)
+            clamped &= encodeAdcSsCtl(count, every) == getCtlRef(8, every);
+    CHECK(ok);
+    CHECK(clamped);
+    CHECK(encodeAdcSsCtl(3, 0) == (ADC_SSCTL1_END2 | ADC_SSCTL1_IE2));
+    CHECK(encodeAdcSsCtl(8, 1) == 0x64444444);
+}
+
+// Each sequencer takes lists up to its depth into its own SSMUXn/SSCTLn,
+// leaves the others alone and ends up enabled; longer lists change nothing
+void testSetSequence()
+{
+    static const uint8_t ain[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    volatile uint32_t *mux0 = &ADC0_SSMUX0_R, *mux1 = &ADC1_SSMUX0_R;
+    uint8_t ss, count, other;
+    bool ok = true, kept = true;
+
+    for (ss = 0; ss < 4; ss++)
+        for (count = 0; count <= 9; count++)
+        {
+            resetMockRegs();
+            bool fits = ss < 3 && count > 0 && count <= getAdcSequencerDepth(ss);
+            ok &= setAdc0Sequence(ss, ain, count) == fits;
+            ok &= setAdc1Sequence(ss, ain, count) == fits;
+            if (fits)
+            {
+                ok &= mux0[ss * 8] == encodeAdcSsMux(ain, count)
+                   && mux0[ss * 8 + 1] == encodeAdcSsCtl(count, 0)
+                   && (ADC0_ACTSS_R & (ADC_ACTSS_ASEN0 << ss));
+                ok &= mux1[ss * 8] == encodeAdcSsMux(ain, count)
+                   && mux1[ss * 8 + 1] == encodeAdcSsCtl(count, 0)
+                   && (ADC1_ACTSS_R & (ADC_ACTSS_ASEN0 << ss));
+            }
+            for (other = 0; other < 3; other++)
+                if (other != ss || !fits)
+                    kept &= mux0[other * 8] == 0 && mux0[other * 8 + 1] == 0
+                         && mux1[other * 8] == 0 && mux1[other * 8 + 1] == 0;
+        }
+    CHECK(ok);
+    CHECK(kept);
+}
+
+int main(void)
+{
+    testDepth();
+    testMux();
+    testCtl();
+    testSetSequence();
+    return finishTest("adcseq");
+}
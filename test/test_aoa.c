@@ -0,0 +1,319 @@
+// Angle of arrival tests: CORDIC and the two-delay solver against double
+// math over all inputs, with host timing
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "tdoa.h"
+#include "aoa.h"
+
+#define RATE 20000
+#define SPACING_MM 100
+
+// Default equilateral layout as main() sets it
+const int16_t micX[3] = {0, -50, 50};
+const int16_t micY[3] = {58, -29, -29};
+
+// Difference between two angles in degrees, wrapped to +/-180
+double getAngleError(double a, double b)
+{
+    double e = fmod(a - b, 360);
+    if (e > 180)
+        e -= 360;
+    if (e <= -180)
+        e += 360;
+    return e;
+}
+
+// Exact delays (1/256 sample, unrounded) of each pair for a far-field
+// source at deg, from positions in mm
+void getDelays(const int16_t *x, const int16_t *y, double deg, double tdoaQ8[3])
+{
+    static const uint8_t pair[3][2] = {{0, 1}, {0, 2}, {1, 2}};
+    double ux = cos(deg * M_PI / 180), uy = sin(deg * M_PI / 180);
+    uint8_t k;
+    for (k = 0; k < 3; k++)
+        tdoaQ8[k] = ((x[pair[k][0]] - x[pair[k][1]]) * ux + (y[pair[k][0]] - y[pair[k][1]]) * uy)
+                    * RATE / SPEED_OF_SOUND_MM * 256;
+}
+
+// CORDIC atan2 at every 1/16 degree and magnitudes from 1 to 2^31 stays
+// within 0.01 degree of libm, and the axes are exact
+void testAtan2()
+{
+    static const double mags[5] = {1000, 1e5, 3e7, 1e9, 2.1e9};
+    double deg, error, worst = 0;
+    int32_t x, y;
+    uint8_t m;
+
+    for (m = 0; m < 5; m++)
+        for (deg = -179.9375; deg <= 180; deg += 0.0625)
+        {
+            x = lround(mags[m] * cos(deg * M_PI / 180));
+            y = lround(mags[m] * sin(deg * M_PI / 180));
+            error = fabs(getAngleError(atan2DegQ8(y, x) / 256.0, atan2(y, x) * 180 / M_PI));
+            if (error > worst)
+                worst = error;
+        }
+    printf("atan2DegQ8: worst error %.4f degrees\n", worst);
+    CHECK(worst < 0.01);
+    CHECK(atan2DegQ8(0, 0) == 0);
+    CHECK(atan2DegQ8(0, 5) == 0);
+    CHECK(atan2DegQ8(5, 0) == 90 * AOA_DEG_Q8);
+    CHECK(atan2DegQ8(0, -5) == 180 * AOA_DEG_Q8);
+    CHECK(atan2DegQ8(-5, 0) == -90 * AOA_DEG_Q8);
+    CHECK(atan2DegQ8(INT32_MIN + 1, INT32_MIN + 1) == -135 * AOA_DEG_Q8);
+}
+
+// Every delay pair the default layout can produce (1/32 sample grid over
+// the lag range) gives the angle double math gets from the same pair
+void testSweep()
+{
+    int16_t maxQ8 = getMaxTdoaLag(SPACING_MM, RATE) * 256;
+    int32_t t12, t13;
+    double ref, error, worst = 0;
+    uint32_t angle;
+    bool range = true;
+
+    for (t12 = -maxQ8; t12 <= maxQ8; t12 += 8)
+        for (t13 = -maxQ8; t13 <= maxQ8; t13 += 8)
+        {
+            if (t12 == 0 && t13 == 0)
+                continue;
+            angle = getAoaDegQ8(t12, t13);
+            range &= angle < 360 * AOA_DEG_Q8;
+            ref = atan2((t12 + t13) / sqrt(3), t12 - t13) * 180 / M_PI;
+            error = fabs(getAngleError(angle / 256.0, ref));
+            if (error > worst)
+                worst = error;
+        }
+    printf("getAoaDegQ8: worst error %.4f degrees over all delay pairs\n", worst);
+    CHECK(worst < 0.02);
+    CHECK(range);
+
+    //the shortest vectors keep their direction
+    CHECK(getAoaDegQ8(1, 0) == 30 * AOA_DEG_Q8);
+    CHECK(getAoaDegQ8(0, -1) == 330 * AOA_DEG_Q8);
+    CHECK(getAoaDegQ8(1, -1) == 0);
+}
+
+// A source at any direction, with its delays rounded to 1/256 sample,
+// comes back within a fraction of a degree (most of it from the layout
+// being equilateral only to the nearest mm)
+void testDirections()
+{
+    double deg, tdoa[3], error, worst = 0;
+
+    for (deg = 0; deg < 360; deg += 0.25)
+    {
+        getDelays(micX, micY, deg, tdoa);
+        error = fabs(getAngleError(getAoaDegQ8(lround(tdoa[0]), lround(tdoa[1])) / 256.0, deg));
+        if (error > worst)
+            worst = error;
+    }
+    printf("getAoaDegQ8: worst error %.3f degrees from 1/256 sample delays\n", worst);
+    CHECK(worst < 0.25);
+}
+
+// Every table entry for a range of spacings and rates matches the solver
+// and double math, and is valid exactly when its lag pair lies within one
+// sample of the circle a far-field source draws
+void testTable()
+{
+    static const uint32_t spacings[4] = {50, 100, 137, 150};
+    static const uint32_t rates[3] = {10000, 20000, 40000};
+    int16_t maxLag, i, j;
+    uint32_t angle;
+    double d, r, error, worst = 0;
+    bool found, match = true, valid = true;
+    uint8_t m, n;
+
+    for (m = 0; m < 4; m++)
+        for (n = 0; n < 3; n++)
+        {
+            maxLag = getMaxTdoaLag(spacings[m], rates[n]);
+            if (!initAoaTable(spacings[m], rates[n]))
+            {
+                CHECK(maxLag > AOA_TABLE_MAX_LAG);
+                CHECK(!lookupAoa(0, 1, &angle));
+                continue;
+            }
+            d = (double)spacings[m] * rates[n] / SPEED_OF_SOUND_MM;
+            for (i = -maxLag - 1; i <= maxLag + 1; i++)
+                for (j = -maxLag - 1; j <= maxLag + 1; j++)
+                {
+                    found = lookupAoa(i, j, &angle);
+                    if (i < -maxLag || i > maxLag || j < -maxLag || j > maxLag)
+                    {
+                        valid &= !found;
+                        continue;
+                    }
+                    //keep clear of the edges, where Q8 rounding decides
+                    r = sqrt((i - j) * (i - j) + (i + j) * (i + j) / 3.0);
+                    if (fabs(fabs(r - d) - 1) > 0.01 && !(d <= 1 && r < 0.01))
+                        valid &= found == (r != 0 && fabs(r - d) <= 1);
+                    if (!found)
+                        continue;
+                    match &= angle == getAoaDegQ8(i * 256, j * 256);
+                    error = fabs(getAngleError(angle / 256.0,
+                                               atan2((i + j) / sqrt(3), i - j) * 180 / M_PI));
+                    if (error > worst)
+                        worst = error;
+                }
+        }
+    printf("aoaTable: worst error %.4f degrees against double math\n", worst);
+    CHECK(match);
+    CHECK(valid);
+    CHECK(worst < 0.01);
+}
+
+// A source at any direction, its delays rounded to whole samples, finds
+// a valid entry in the default table within the whole-sample resolution
+void testTableDirections()
+{
+    double deg, tdoa[3], error, worst = 0;
+    uint32_t angle;
+    bool found = true;
+
+    CHECK(initAoaTable(SPACING_MM, RATE));
+    for (deg = 0; deg < 360; deg += 0.25)
+    {
+        getDelays(micX, micY, deg, tdoa);
+        if (!lookupAoa(lround(tdoa[0] / 256), lround(tdoa[1] / 256), &angle))
+        {
+            found = false;
+            continue;
+        }
+        error = fabs(getAngleError(angle / 256.0, deg));
+        if (error > worst)
+            worst = error;
+    }
+    printf("aoaTable: worst error %.1f degrees from whole-sample delays\n", worst);
+    CHECK(found);
+    CHECK(worst < 10);
+}
+
+// The least-squares solver finds any direction on several layouts with a
+// residual near zero, rejects collinear mics and zero delays, and reports
+// an inconsistent delay in its residual
+void testSolve()
+{
+    static const int16_t layoutX[3][3] = {{0, -50, 50}, {0, 120, 0}, {-200, 35, 180}};
+    static const int16_t layoutY[3][3] = {{58, -29, -29}, {0, 0, 90}, {10, 140, -60}};
+    static const int16_t lineX[3] = {-100, 0, 100}, lineY[3] = {-50, 0, 50};
+    double deg, tdoa[3], error, worst = 0;
+    int32_t tdoaQ8[3] = {0, 0, 0};
+    uint32_t angle, residual, worstResidual = 0;
+    bool solved = true;
+    uint8_t m, k;
+
+    for (m = 0; m < 3; m++)
+        for (deg = 0; deg < 360; deg += 0.5)
+        {
+            getDelays(layoutX[m], layoutY[m], deg, tdoa);
+            for (k = 0; k < 3; k++)
+                tdoaQ8[k] = lround(tdoa[k]);
+            solved &= solveAoa(layoutX[m], layoutY[m], tdoaQ8, &angle, &residual);
+            error = fabs(getAngleError(angle / 256.0, deg));
+            if (error > worst)
+                worst = error;
+            if (residual > worstResidual)
+                worstResidual = residual;
+        }
+    printf("solveAoa: worst error %.3f degrees, residual %u/256 sample\n", worst,
+           worstResidual);
+    CHECK(solved);
+    CHECK(worst < 0.1);
+    CHECK(worstResidual <= 1);
+
+    tdoaQ8[0] = 256;
+    CHECK(!solveAoa(lineX, lineY, tdoaQ8, &angle, &residual));
+    tdoaQ8[0] = tdoaQ8[1] = tdoaQ8[2] = 0;
+    CHECK(!solveAoa(micX, micY, tdoaQ8, &angle, &residual));
+
+    //a pair 2-3 delay off by a whole sample shows as about 1/3 sample
+    getDelays(micX, micY, 40, tdoa);
+    for (k = 0; k < 3; k++)
+        tdoaQ8[k] = lround(tdoa[k]);
+    tdoaQ8[2] += 256;
+    CHECK(solveAoa(micX, micY, tdoaQ8, &angle, &residual));
+    CHECK(residual > 80 && residual < 120);
+}
+
+// With independent noise on each delay, using all three pairs spreads the
+// angle less than the two-delay solution does
+void testSolveJitter()
+{
+    double deg, tdoa[3], e2, e3, sum2 = 0, sum3 = 0;
+    int32_t tdoaQ8[3];
+    uint32_t angle, residual;
+    uint16_t n;
+    uint8_t k;
+
+    for (n = 0; n < 20000; n++)
+    {
+        deg = n * 0.018;
+        getDelays(micX, micY, deg, tdoa);
+        for (k = 0; k < 3; k++)
+            tdoaQ8[k] = lround(tdoa[k]) + getTestNoise(64);
+        e2 = getAngleError(getAoaDegQ8(tdoaQ8[0], tdoaQ8[1]) / 256.0, deg);
+        solveAoa(micX, micY, tdoaQ8, &angle, &residual);
+        e3 = getAngleError(angle / 256.0, deg);
+        sum2 += e2 * e2;
+        sum3 += e3 * e3;
+    }
+    printf("angle jitter (degrees RMS, +/-1/4 sample delay noise): two delays %.2f, "
+           "least squares %.2f\n", sqrt(sum2 / 20000), sqrt(sum3 / 20000));
+    CHECK(sum3 < sum2 * 0.8);
+}
+
+// Host time per solve
+void benchmarkAoa()
+{
+    volatile uint32_t angle;
+    uint32_t looked = 0, residual;
+    int32_t tdoaQ8[3];
+    uint64_t start;
+    uint32_t n;
+
+    start = getTestNs();
+    for (n = 0; n < 1000000; n++)
+        angle = getAoaDegQ8((int32_t)(n & 0x7FF) - 1024, 700 - (int32_t)(n & 0x3FF));
+    printf("getAoaDegQ8: %.1f ns per solve on the host\n", (getTestNs() - start) / 1e6);
+
+    initAoaTable(SPACING_MM, RATE);
+    start = getTestNs();
+    for (n = 0; n < 1000000; n++)
+    {
+        lookupAoa((int16_t)(n % 13) - 6, (int16_t)(n % 11) - 5, &looked);
+        angle = looked;
+    }
+    printf("lookupAoa: %.1f ns per lookup on the host\n", (getTestNs() - start) / 1e6);
+
+    start = getTestNs();
+    for (n = 0; n < 1000000; n++)
+    {
+        tdoaQ8[0] = (int32_t)(n & 0x3FF) - 512;
+        tdoaQ8[1] = 300 - (int32_t)(n & 0x1FF);
+        tdoaQ8[2] = tdoaQ8[1] - tdoaQ8[0];
+        solveAoa(micX, micY, tdoaQ8, &looked, &residual);
+        angle = looked;
+    }
+    printf("solveAoa: %.1f ns per solve on the host\n", (getTestNs() - start) / 1e6);
+    (void)angle;
+}
+
+int main(void)
+{
+    testAtan2();
+    testSweep();
+    testDirections();
+    testTable();
+    testTableDirections();
+    testSolve();
+    testSolveJitter();
+    benchmarkAoa();
+    return finishTest("aoa");
+}
@@ -0,0 +1,120 @@
+// Pre-trigger capture ring tests
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "capture.h"
+
+// Sample n of mic m reads back as n plus 1000 * m (16-bit wrap intended)
+void writeSamples(uint32_t count)
+{
+    uint32_t i, n;
+    for (i = 0; i < count; i++)
+    {
+        n = getCaptureCount();
+        writeCapture(n, n + 1000, n + 2000);
+    }
+}
+
+// True if the window reads back the samples it names from every ring
+bool isWindowIntact(const CAPTURE_WINDOW *win)
+{
+    uint16_t k;
+    uint8_t m;
+    bool ok = true;
+    for (m = 0; m < CAPTURE_MICS; m++)
+        for (k = 0; k < win->length; k++)
+            ok &= getCaptureRing(m)[(win->start + k) & CAPTURE_MASK]
+                  == (int16_t)(win->start + k + 1000 * m);
+    return ok;
+}
+
+// The window holds CAPTURE_PRE samples before the trigger and is handed
+// out once the post-trigger samples are in, straight from the ring
+void testWindow()
+{
+    CAPTURE_WINDOW win;
+
+    initCapture();
+    writeSamples(1000);
+    CHECK(triggerCapture());
+    CHECK(getCaptureHold(&win));
+    CHECK(win.start == 999 - CAPTURE_PRE && win.trigger == CAPTURE_PRE);
+    CHECK(win.length == CAPTURE_PRE + CAPTURE_POST);
+    writeSamples(CAPTURE_POST - 2);
+    CHECK(!getCaptureWindow(&win));
+    writeSamples(1);
+    CHECK(getCaptureWindow(&win));
+    CHECK(win.start + win.trigger == 999);
+    CHECK(isWindowIntact(&win));
+    CHECK(releaseCapture());
+    CHECK(!getCaptureWindow(&win) && !getCaptureHold(&win));
+}
+
+// A trigger while a window is held is ignored; after release the next one
+// is taken
+void testHeld()
+{
+    CAPTURE_WINDOW win;
+
+    initCapture();
+    writeSamples(CAPTURE_PRE + 1);
+    CHECK(triggerCapture());
+    writeSamples(10);
+    CHECK(!triggerCapture());
+    getCaptureHold(&win);
+    CHECK(win.start == 0);
+    writeSamples(CAPTURE_POST);
+    CHECK(releaseCapture());
+    CHECK(triggerCapture());
+    getCaptureHold(&win);
+    CHECK(win.start == CAPTURE_POST + 10);
+}
+
+// Capture keeps running into the other half of the ring; the window stays
+// intact until capture has wrapped into it, and releasing it reports that
+void testWrap()
+{
+    CAPTURE_WINDOW win;
+
+    initCapture();
+    writeSamples(5000);
+    triggerCapture();
+    getCaptureHold(&win);
+    writeSamples(CAPTURE_LEN - CAPTURE_PRE - 1);
+    CHECK(getCaptureWindow(&win));
+    CHECK(isWindowIntact(&win));
+    CHECK(releaseCapture());
+
+    triggerCapture();
+    getCaptureHold(&win);
+    writeSamples(CAPTURE_LEN - CAPTURE_PRE);
+    CHECK(!isWindowIntact(&win));
+    CHECK(!releaseCapture());
+}
+
+// A trigger before CAPTURE_PRE samples exist still gives a full-length
+// window (its start wraps below zero onto unwritten ring entries)
+void testEarlyTrigger()
+{
+    CAPTURE_WINDOW win;
+
+    initCapture();
+    writeSamples(10);
+    CHECK(triggerCapture());
+    writeSamples(CAPTURE_POST - 2);
+    CHECK(!getCaptureWindow(&win));
+    writeSamples(1);
+    CHECK(getCaptureWindow(&win));
+    CHECK(win.start + win.trigger == 9);
+    CHECK(releaseCapture());
+}
+
+int main(void)
+{
+    testWindow();
+    testHeld();
+    testWrap();
+    testEarlyTrigger();
+    return finishTest("capture");
+}
@@ -0,0 +1,124 @@
+// ADC0 digital comparator tests against the simulated comparators
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "adc0.h"
+#include "adcsim.h"
+
+#define HIGH 2300
+#define LOW 2200
+
+// MIC1 and MIC3 to the FIFO, then again to comparators 0 and 1
+const uint8_t ain[4] = {1, 4, 1, 4};
+
+// Input level (counts) of MIC1 and MIC3
+int16_t level[2];
+
+int16_t levelSignal(uint8_t a, uint32_t timeNs)
+{
+    (void)timeNs;
+    return a == 1 ? level[0] : level[1];
+}
+
+// Program ADC0 SS1 the way main() does, both comparators on HIGH/LOW
+void startComparators()
+{
+    resetMockRegs();
+    initAdcSim(levelSignal);
+    initAdc0Ss1();
+    setAdc0Ss1Sequence(ain, 4);
+    setAdc0Ss1StepComparator(2, 0);
+    setAdc0Ss1StepComparator(3, 1);
+    setAdc0Comparator(0, HIGH, LOW);
+    setAdc0Comparator(1, HIGH, LOW);
+    enableAdc0ComparatorInterrupt();
+    level[0] = level[1] = 2048;
+}
+
+// Convert one sequence at MIC1/MIC3 levels, drain the FIFO and return the
+// comparator interrupts it raised (clearing them as the ISR does)
+uint8_t convert(int16_t mic1, int16_t mic3)
+{
+    int16_t dst[4];
+    level[0] = mic1;
+    level[1] = mic3;
+    triggerAdcSim(0, 0);
+    readAdc0Ss1Block(dst, 4);
+    return clearAdc0ComparatorInterrupt();
+}
+
+// Comparator steps never reach the FIFO
+void testRouting()
+{
+    startComparators();
+    level[0] = 3000;
+    level[1] = 1000;
+    triggerAdcSim(0, 0);
+    CHECK(getAdcSimFifoCount(0) == 2);
+}
+
+// One interrupt when a sample reaches the high band; none while it stays
+// high or drops only to the mid band; another only after a sample falls
+// below the low band
+void testHysteresisOnce()
+{
+    startComparators();
+    CHECK(convert(2048, 2048) == 0);
+    CHECK(convert(HIGH - 1, 2048) == 0);
+    CHECK(convert(HIGH, 2048) == 1);
+    CHECK(convert(4095, 2048) == 0);
+    CHECK(convert(LOW, 2048) == 0);
+    CHECK(convert(HIGH + 50, 2048) == 0);
+    CHECK(convert(LOW - 1, 2048) == 0);
+    CHECK(convert(HIGH + 50, 2048) == 1);
+}
+
+// The comparators latch independently and both report in one status
+void testIndependent()
+{
+    startComparators();
+    CHECK(convert(2048, 3000) == 2);
+    CHECK(convert(3000, 3000) == 1);
+    CHECK(convert(1000, 1000) == 0);
+    CHECK(convert(3000, 3000) == 3);
+}
+
+// An interrupt stays pending until cleared, and clearing it does not re-arm
+void testClear()
+{
+    int16_t dst[4];
+    startComparators();
+    level[0] = 3000;
+    triggerAdcSim(0, 0);
+    readAdc0Ss1Block(dst, 4);
+    level[0] = LOW + 50;
+    triggerAdcSim(0, 0);
+    readAdc0Ss1Block(dst, 4);
+    CHECK(clearAdc0ComparatorInterrupt() == 1);
+    CHECK(clearAdc0ComparatorInterrupt() == 0);
+    CHECK(convert(3000, 2048) == 0);
+}
+
+// Reprogramming a comparator (a new trigger level) resets its latch, so a
+// signal already above the new level fires again; the other one is untouched
+void testReprogram()
+{
+    startComparators();
+    CHECK(convert(3000, 3000) == 3);
+    setAdc0Comparator(0, 2500, 2400);
+    CHECK(convert(3000, 3000) == 1);
+    setAdc0Comparator(0, 3500, 3400);
+    CHECK(convert(3000, 3000) == 0);
+    CHECK(convert(3600, 3000) == 1);
+}
+
+int main(void)
+{
+    testRouting();
+    testHysteresisOnce();
+    testIndependent();
+    testClear();
+    testReprogram();
+    return finishTest("comparator");
+}
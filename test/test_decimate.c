@@ -0,0 +1,132 @@
+// CIC decimator tests (Q3 output), with a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "decimate.h"
+
+// Run n inputs of x through cic, returning the last output
+int16_t settle(CIC_DECIMATOR *cic, int16_t x, uint16_t n)
+{
+    int16_t y = 0;
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        filterCicDecimator(cic, x, &y);
+    return y;
+}
+
+// An output comes every 2^log2Factor inputs, and a steady input comes out
+// as itself in Q3 at every factor, including pass-through
+void testDc()
+{
+    static const int16_t levels[4] = {0, 1, 2047, 4095};
+    CIC_DECIMATOR cic;
+    int16_t y;
+    uint16_t n, outputs;
+    uint8_t log2Factor, l;
+    bool rate = true, dc = true;
+
+    for (log2Factor = 0; log2Factor <= CIC_MAX_LOG2_FACTOR; log2Factor++)
+    {
+        initCicDecimator(&cic, log2Factor);
+        outputs = 0;
+        for (n = 0; n < 1024; n++)
+            outputs += filterCicDecimator(&cic, 100, &y);
+        rate &= outputs == 1024 >> log2Factor;
+        for (l = 0; l < 4; l++)
+        {
+            initCicDecimator(&cic, log2Factor);
+            dc &= settle(&cic, levels[l], 2 << log2Factor) == levels[l] * CIC_ONE;
+        }
+    }
+    CHECK(rate);
+    CHECK(dc);
+    initCicDecimator(&cic, CIC_MAX_LOG2_FACTOR + 1);
+    CHECK(cic.log2Factor == CIC_MAX_LOG2_FACTOR);
+}
+
+// The fraction bits hold the average below one count: a pattern repeating
+// every 8 inputs with k of them one count higher decimates by 8 to exactly
+// base + k/8
+void testFraction()
+{
+    CIC_DECIMATOR cic;
+    int16_t y = 0;
+    uint16_t n;
+    uint8_t k;
+    bool exact = true;
+
+    for (k = 0; k < 8; k++)
+    {
+        initCicDecimator(&cic, 3);
+        for (n = 0; n < 64; n++)
+            filterCicDecimator(&cic, 2048 + ((n & 7) < k), &y);
+        exact &= y == 2048 * CIC_ONE + k;
+    }
+    CHECK(exact);
+}
+
+// White noise comes out with the sinc^2 (triangle) noise power gain of
+// (2F^2 + 1) / 3F^3 at factor F, so the RMS drops with the factor instead
+// of rounding away
+void testNoise()
+{
+    CIC_DECIMATOR cic;
+    double in = 0, out = 0, ratio, expected;
+    int16_t x, y;
+    uint32_t n, outputs;
+    uint8_t log2Factor;
+    double f;
+
+    for (log2Factor = 1; log2Factor <= 3; log2Factor++)
+    {
+        initCicDecimator(&cic, log2Factor);
+        in = out = 0;
+        outputs = 0;
+        for (n = 0; n < 65536; n++)
+        {
+            x = getTestNoise(100);
+            in += (double)x * x;
+            if (filterCicDecimator(&cic, 2048 + x, &y) && n > 64)
+            {
+                out += ((double)y / CIC_ONE - 2048) * ((double)y / CIC_ONE - 2048);
+                outputs++;
+            }
+        }
+        ratio = sqrt((out / outputs) / (in / n));
+        f = 1 << log2Factor;
+        expected = sqrt((2 * f * f + 1) / (3 * f * f * f));
+        printf("factor %d: noise RMS ratio %.3f (expected about %.3f)\n", 1 << log2Factor, ratio,
+               expected);
+        CHECK(fabs(ratio - expected) < 0.05 * expected);
+    }
+}
+
+// Host time per input sample at the largest factor main() uses
+void benchmarkDecimate()
+{
+    CIC_DECIMATOR cic;
+    int16_t y;
+    volatile int16_t sink;
+    uint64_t start;
+    uint32_t n;
+
+    initCicDecimator(&cic, 3);
+    start = getTestNs();
+    for (n = 0; n < 10000000; n++)
+        if (filterCicDecimator(&cic, n & 0xFFF, &y))
+            sink = y;
+    (void)sink;
+    printf("filterCicDecimator: %.2f ns/input on the host\n", (getTestNs() - start) / 1e7);
+}
+
+int main(void)
+{
+    testDc();
+    testFraction();
+    testNoise();
+    benchmarkDecimate();
+    return finishTest("decimate");
+}
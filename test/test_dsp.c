@@ -0,0 +1,126 @@
+// Packed Q15 kernels against their scalar references on random data, with
+// a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "test.h"
+#include "dsp.h"
+
+#define LEN 600
+#define TRIALS 2000
+
+int16_t x[LEN + 8], y[LEN + 8], h[LEN + 8];
+int16_t out[LEN + 8], outRef[LEN + 8];
+
+// Random samples, mostly full scale, with the extremes thrown in often so
+// the saturating kernels clip and the 32-bit pair products hit -32768^2
+int16_t getSample()
+{
+    uint32_t r = getTestRandom();
+    switch (r % 8)
+    {
+        case 0:  return -32768;
+        case 1:  return 32767;
+        case 2:  return (int16_t)(r >> 16) >> 8;
+        default: return (int16_t)(r >> 16);
+    }
+}
+
+void fillRandom(int16_t *p, uint16_t n)
+{
+    uint16_t i;
+    for (i = 0; i < n; i++)
+        p[i] = getSample();
+}
+
+// Random lengths (odd, even and zero) and start offsets (so the pairs are
+// not always word aligned) give bit-identical results
+void testKernels()
+{
+    uint16_t t, n, taps, count, ox, oy;
+    int16_t lag;
+    bool dot = true, fir = true, corr = true, squares = true, add = true, inPlace = true;
+
+    for (t = 0; t < TRIALS; t++)
+    {
+        fillRandom(x, LEN + 8);
+        fillRandom(y, LEN + 8);
+        fillRandom(h, LEN + 8);
+        n = getTestRandom() % (LEN / 2);
+        ox = getTestRandom() % 4;
+        oy = getTestRandom() % 4;
+
+        dot &= dotQ15(x + ox, y + oy, n) == dotQ15Ref(x + ox, y + oy, n);
+        squares &= sumSquaresQ15(x + ox, n) == sumSquaresQ15Ref(x + ox, n);
+
+        lag = (int16_t)(getTestRandom() % 9) - 4;
+        corr &= correlateLagQ15(x + ox, y + 4, n, lag) == correlateLagQ15Ref(x + ox, y + 4, n, lag);
+
+        taps = 1 + getTestRandom() % 40;
+        count = getTestRandom() % (LEN / 2);
+        memset(out, 0, sizeof(out));
+        memset(outRef, 0, sizeof(outRef));
+        firQ15(x + ox, out, count, h + oy, taps);
+        firQ15Ref(x + ox, outRef, count, h + oy, taps);
+        fir &= memcmp(out, outRef, sizeof(out)) == 0;
+
+        addSatQ15(x + ox, y + oy, out, n);
+        addSatQ15Ref(x + ox, y + oy, outRef, n);
+        add &= memcmp(out, outRef, n * 2) == 0;
+        memcpy(out, x + ox, n * 2);
+        addSatQ15(out, y + oy, out, n);
+        inPlace &= memcmp(out, outRef, n * 2) == 0;
+    }
+    CHECK(dot);
+    CHECK(fir);
+    CHECK(corr);
+    CHECK(squares);
+    CHECK(add);
+    CHECK(inPlace);
+}
+
+// The pair sums cannot overflow: a full-length block of -32768 squared
+void testExtremes()
+{
+    uint16_t i;
+    for (i = 0; i < LEN; i++)
+        x[i] = y[i] = -32768;
+    CHECK(dotQ15(x, y, LEN) == (int64_t)LEN << 30);
+    CHECK(sumSquaresQ15(x, LEN) == (uint64_t)LEN << 30);
+    addSatQ15(x, y, out, 3);
+    CHECK(out[0] == -32768 && out[2] == -32768);
+}
+
+// Host time per sample of the packed and scalar dot products; on the host
+// the packed instructions are emulated, so only the M4 estimates in dsp.h
+// say which is faster there
+void benchmarkDsp()
+{
+    volatile int64_t sink;
+    uint64_t start, packed, scalar;
+    uint32_t i;
+
+    fillRandom(x, LEN);
+    fillRandom(y, LEN);
+    start = getTestNs();
+    for (i = 0; i < 20000; i++)
+        sink = dotQ15(x, y, LEN);
+    packed = getTestNs() - start;
+    start = getTestNs();
+    for (i = 0; i < 20000; i++)
+        sink = dotQ15Ref(x, y, LEN);
+    scalar = getTestNs() - start;
+    (void)sink;
+    printf("dotQ15: %.2f ns/sample packed, %.2f scalar on the host\n", packed / (20000.0 * LEN),
+           scalar / (20000.0 * LEN));
+}
+
+int main(void)
+{
+    testKernels();
+    testExtremes();
+    benchmarkDsp();
+    return finishTest("dsp");
+}
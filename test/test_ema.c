@@ -0,0 +1,97 @@
+// Exponential moving average tests, with a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "ema.h"
+
+// The time constant in samples goes to the nearest power of two (rounding
+// up from 1.5 times one), for every length up to past the largest one
+void testLog2Tau()
+{
+    uint32_t samples;
+    uint8_t ref;
+    bool ok = true;
+
+    CHECK(getEmaLog2Tau(0, 20000) == 0);
+    CHECK(getEmaLog2Tau(1, 1000) == 0);
+    CHECK(getEmaLog2Tau(2, 1000) == 1);
+    CHECK(getEmaLog2Tau(3, 1000) == 2);
+    CHECK(getEmaLog2Tau(5, 1000) == 2);
+    CHECK(getEmaLog2Tau(6, 1000) == 3);
+    CHECK(getEmaLog2Tau(1, 20000) == 4);
+    CHECK(getEmaLog2Tau(100, 20000) == 11);
+    CHECK(getEmaLog2Tau(100000, 20000) == EMA_MAX_LOG2_TAU);
+    CHECK(getEmaLog2Tau(0xFFFFFFFF, 1000000) == EMA_MAX_LOG2_TAU);
+
+    for (samples = 1; samples < 100000; samples++)
+    {
+        ref = 0;
+        while (ref < EMA_MAX_LOG2_TAU && samples >= 1.5 * (1 << ref))
+            ref++;
+        ok &= getEmaLog2Tau(samples, 1000) == ref;
+    }
+    CHECK(ok);
+}
+
+// A step reaches 1 - (1 - 2^-log2Tau)^(2^log2Tau) of its height (1 - 1/e
+// for long time constants) after 2^log2Tau samples, and
+// a steady input settles on exactly itself (no bias from the shifts), for
+// full-scale Q3 samples of either sign
+void testResponse()
+{
+    static const int16_t levels[4] = {-32768, -1, 1, 32760};
+    EMA ema;
+    double share;
+    uint32_t n;
+    uint8_t log2Tau, l;
+    bool step = true, settled = true;
+
+    for (log2Tau = 2; log2Tau <= EMA_MAX_LOG2_TAU; log2Tau++)
+    {
+        initEma(&ema, log2Tau, 0);
+        for (n = 0; n < (1u << log2Tau); n++)
+            filterEma(&ema, 16000);
+        share = getEma(&ema) / 16000.0;
+        step &= fabs(share - (1 - pow(1 - 1.0 / (1 << log2Tau), 1 << log2Tau))) < 0.005;
+
+        for (l = 0; l < 4; l++)
+        {
+            initEma(&ema, log2Tau, 0);
+            for (n = 0; n < (40u << log2Tau); n++)
+                filterEma(&ema, levels[l]);
+            settled &= getEma(&ema) == levels[l];
+        }
+    }
+    CHECK(step);
+    CHECK(settled);
+
+    initEma(&ema, EMA_MAX_LOG2_TAU + 3, -1234);
+    CHECK(ema.log2Tau == EMA_MAX_LOG2_TAU && getEma(&ema) == -1234);
+}
+
+// Host time per update
+void benchmarkEma()
+{
+    EMA ema;
+    volatile int16_t y;
+    uint64_t start;
+    uint32_t n;
+
+    initEma(&ema, 11, 0);
+    start = getTestNs();
+    for (n = 0; n < 10000000; n++)
+        y = filterEma(&ema, n);
+    (void)y;
+    printf("filterEma: %.2f ns/sample on the host\n", (getTestNs() - start) / 1e7);
+}
+
+int main(void)
+{
+    testLog2Tau();
+    testResponse();
+    benchmarkEma();
+    return finishTest("ema");
+}
@@ -0,0 +1,259 @@
+// DC blocker and biquad filter bank tests against a double-precision
+// reference, with a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "test.h"
+#include "filterbank.h"
+
+#define RATE 20000
+#define FRAMES 4000
+#define BLOCK 16
+#define DC_SHIFT 10
+
+// The same filter in double precision: running-mean DC blocker (seeded
+// with the first sample) and the cookbook Butterworth sections
+typedef struct _REF_FILTER
+{
+    double b[FILTER_MAX_STAGES][3], a[FILTER_MAX_STAGES][2];
+    double x1[FILTER_MAX_STAGES], x2[FILTER_MAX_STAGES];
+    double y1[FILTER_MAX_STAGES], y2[FILTER_MAX_STAGES];
+    double dc;
+    uint8_t stages;
+    bool primed;
+} REF_FILTER;
+
+void setRefBiquad(REF_FILTER *rf, uint32_t cornerHz, bool highPass)
+{
+    double w = 2 * M_PI * cornerHz / RATE;
+    double alpha = sin(w) / sqrt(2), c = cos(w), a0 = 1 + alpha;
+    uint8_t i = rf->stages++;
+    rf->b[i][0] = (highPass ? (1 + c) / 2 : (1 - c) / 2) / a0;
+    rf->b[i][1] = (highPass ? -(1 + c) : 1 - c) / a0;
+    rf->b[i][2] = rf->b[i][0];
+    rf->a[i][0] = -2 * c / a0;
+    rf->a[i][1] = (1 - alpha) / a0;
+    rf->x1[i] = rf->x2[i] = rf->y1[i] = rf->y2[i] = 0;
+}
+
+void initRefFilter(REF_FILTER *rf, uint32_t lowHz, uint32_t highHz)
+{
+    rf->stages = 0;
+    rf->primed = false;
+    if (lowHz != 0)
+        setRefBiquad(rf, lowHz, true);
+    if (highHz != 0)
+        setRefBiquad(rf, highHz, false);
+}
+
+double filterRef(REF_FILTER *rf, double x)
+{
+    double y;
+    uint8_t i;
+    if (!rf->primed)
+    {
+        rf->dc = x;
+        rf->primed = true;
+    }
+    rf->dc += (x - rf->dc) / (1 << DC_SHIFT);
+    x -= rf->dc;
+    for (i = 0; i < rf->stages; i++)
+    {
+        y = rf->b[i][0] * x + rf->b[i][1] * rf->x1[i] + rf->b[i][2] * rf->x2[i]
+            - rf->a[i][0] * rf->y1[i] - rf->a[i][1] * rf->y2[i];
+        rf->x2[i] = rf->x1[i];
+        rf->x1[i] = x;
+        rf->y2[i] = rf->y1[i];
+        rf->y1[i] = y;
+        x = y;
+    }
+    return x;
+}
+
+// Mic-like input: bias, a tone per channel and broadband noise, in Q3 units
+int16_t getInput(uint8_t ch, uint16_t n)
+{
+    static const double tones[FILTER_CHANNELS] = {150, 1200, 3700};
+    return 1200 * (ch + 1) + lround(6000 * sin(2 * M_PI * tones[ch] * n / RATE))
+           + getTestNoise(4000);
+}
+
+// Q30 coefficients match the double formulas to within a few LSB for
+// corners across the band
+void testCoefficients()
+{
+    static const uint32_t corners[5] = {20, 100, 1000, 4000, 9000};
+    FILTER_BANK fb;
+    REF_FILTER rf;
+    double worst = 0, e;
+    uint8_t c, i, k;
+
+    initFilterBank(&fb, DC_SHIFT);
+    for (c = 0; c < 5; c++)
+        for (i = 0; i < 2; i++)
+        {
+            setFilterBankBand(&fb, i ? 0 : corners[c], i ? corners[c] : 0, RATE);
+            initRefFilter(&rf, i ? 0 : corners[c], i ? corners[c] : 0);
+            for (k = 0; k < 3; k++)
+            {
+                e = fabs((&fb.stage[0].b0)[k] - rf.b[0][k] * (1 << 30));
+                worst = e > worst ? e : worst;
+            }
+            for (k = 0; k < 2; k++)
+            {
+                e = fabs((&fb.stage[0].a1)[k] - rf.a[0][k] * (1 << 30));
+                worst = e > worst ? e : worst;
+            }
+        }
+    printf("coefficients: worst error %.1f Q30 LSB\n", worst);
+    CHECK(worst < 16);
+}
+
+// All three channels, filtered in blocks, stay within about a count of the
+// double reference for several bands
+void testReference()
+{
+    static const uint32_t bands[4][2] = {{0, 0}, {100, 0}, {0, 2000}, {300, 4000}};
+    static int16_t input[FRAMES * FILTER_CHANNELS], frames[FRAMES * FILTER_CHANNELS];
+    FILTER_BANK fb;
+    REF_FILTER rf;
+    double e, sum, worst;
+    uint16_t n;
+    uint8_t b, ch;
+
+    for (n = 0; n < FRAMES; n++)
+        for (ch = 0; ch < FILTER_CHANNELS; ch++)
+            input[n * FILTER_CHANNELS + ch] = getInput(ch, n);
+
+    printf("band Hz      error (counts): RMS  worst\n");
+    for (b = 0; b < 4; b++)
+    {
+        for (n = 0; n < FRAMES * FILTER_CHANNELS; n++)
+            frames[n] = input[n];
+        initFilterBank(&fb, DC_SHIFT);
+        CHECK(setFilterBankBand(&fb, bands[b][0], bands[b][1], RATE));
+        for (n = 0; n < FRAMES; n += BLOCK)
+            filterFilterBank(&fb, &frames[n * FILTER_CHANNELS], BLOCK);
+
+        sum = worst = 0;
+        for (ch = 0; ch < FILTER_CHANNELS; ch++)
+        {
+            initRefFilter(&rf, bands[b][0], bands[b][1]);
+            for (n = 0; n < FRAMES; n++)
+            {
+                e = fabs(frames[n * FILTER_CHANNELS + ch]
+                         - filterRef(&rf, input[n * FILTER_CHANNELS + ch]));
+                sum += e * e;
+                worst = e > worst ? e : worst;
+            }
+        }
+        printf("%4u-%-4u  %20.3f  %5.2f\n", bands[b][0], bands[b][1],
+               sqrt(sum / (FRAMES * FILTER_CHANNELS)), worst);
+        CHECK(sqrt(sum / (FRAMES * FILTER_CHANNELS)) < 1);
+        CHECK(worst < 2);
+    }
+}
+
+// Tone gains match the bilinear-transformed Butterworth response to within
+// 0.1 dB, in the pass band and the stop bands
+void testResponse()
+{
+    static const double tones[6] = {50, 100, 300, 1000, 2000, 5000};
+    static int16_t frames[FRAMES * FILTER_CHANNELS];
+    FILTER_BANK fb;
+    double wl = tan(M_PI * 100 / RATE), wh = tan(M_PI * 2000 / RATE), w, h;
+    double sum, gain, expected;
+    uint16_t n;
+    uint8_t t;
+
+    for (t = 0; t < 6; t++)
+    {
+        for (n = 0; n < FRAMES; n++)
+            frames[n * FILTER_CHANNELS] = frames[n * FILTER_CHANNELS + 1] =
+                frames[n * FILTER_CHANNELS + 2] = lround(10000 * sin(2 * M_PI * tones[t] * n / RATE));
+        initFilterBank(&fb, FILTER_MAX_DC_SHIFT);
+        setFilterBankBand(&fb, 100, 2000, RATE);
+        filterFilterBank(&fb, frames, FRAMES);
+        //RMS over the second half, a whole number of periods of every tone
+        sum = 0;
+        for (n = FRAMES / 2; n < FRAMES; n++)
+            sum += (double)frames[n * FILTER_CHANNELS] * frames[n * FILTER_CHANNELS];
+        gain = 20 * log10(sqrt(sum / (FRAMES / 2)) / (10000 / sqrt(2)));
+
+        //|H|^2 = 1 / (1 + (wl / w)^4) for the high-pass, 1 / (1 + (w / wh)^4)
+        //for the low-pass, at the prewarped frequency w
+        w = tan(M_PI * tones[t] / RATE);
+        h = 1 / sqrt((1 + pow(wl / w, 4)) * (1 + pow(w / wh, 4)));
+        expected = 20 * log10(h);
+        printf("%5.0f Hz: %7.2f dB (expected %7.2f)\n", tones[t], gain, expected);
+        CHECK(fabs(gain - expected) < 0.1);
+    }
+}
+
+// A bias step is removed with the DC time constant, and the estimate
+// reads back the bias
+void testDc()
+{
+    static int16_t frames[8192 * FILTER_CHANNELS];
+    FILTER_BANK fb;
+    uint16_t n;
+    uint8_t ch;
+
+    for (n = 0; n < 8192; n++)
+        for (ch = 0; ch < FILTER_CHANNELS; ch++)
+            frames[n * FILTER_CHANNELS + ch] = (n < 100 ? 2000 : 2400) * (ch + 1);
+    initFilterBank(&fb, 8);
+    setFilterBankBand(&fb, 0, 0, RATE);
+    filterFilterBank(&fb, frames, 8192);
+    CHECK(frames[0] == 0 && frames[1] == 0 && frames[2] == 0);
+    CHECK(frames[100 * FILTER_CHANNELS] > 390 && frames[100 * FILTER_CHANNELS] <= 400);
+    CHECK(abs(frames[8191 * FILTER_CHANNELS + 2]) <= 1);
+    for (ch = 0; ch < FILTER_CHANNELS; ch++)
+        CHECK(abs(getFilterBankDc(&fb, ch) - 2400 * (ch + 1)) <= 1);
+}
+
+// Bands above Nyquist or out of order are refused
+void testBand()
+{
+    FILTER_BANK fb;
+    initFilterBank(&fb, DC_SHIFT);
+    CHECK(setFilterBankBand(&fb, 100, 2000, RATE));
+    CHECK(fb.stages == 2);
+    CHECK(setFilterBankBand(&fb, 0, 0, RATE));
+    CHECK(fb.stages == 0);
+    CHECK(!setFilterBankBand(&fb, 2000, 100, RATE));
+    CHECK(!setFilterBankBand(&fb, 0, RATE / 2, RATE));
+    CHECK(!setFilterBankBand(&fb, RATE / 2, 0, RATE));
+}
+
+// Host time per three-channel frame through the DC blocker and two sections
+void benchmarkFilterBank()
+{
+    static int16_t frames[BLOCK * FILTER_CHANNELS];
+    FILTER_BANK fb;
+    uint64_t start;
+    uint32_t n;
+
+    initFilterBank(&fb, DC_SHIFT);
+    setFilterBankBand(&fb, 100, 2000, RATE);
+    for (n = 0; n < BLOCK * FILTER_CHANNELS; n++)
+        frames[n] = getTestNoise(8000);
+    start = getTestNs();
+    for (n = 0; n < 1000000 / BLOCK; n++)
+        filterFilterBank(&fb, frames, BLOCK);
+    printf("filterFilterBank: %.1f ns/frame on the host\n", (getTestNs() - start) / 1e6);
+}
+
+int main(void)
+{
+    testCoefficients();
+    testReference();
+    testResponse();
+    testDc();
+    testBand();
+    benchmarkFilterBank();
+    return finishTest("filterbank");
+}
@@ -0,0 +1,131 @@
+// Fractional delay and skew alignment tests, with a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "fracdelay.h"
+
+#define RATE 20000
+#define SAMPLES 2000
+#define WARMUP FRAC_DELAY_TAPS
+#define AMPLITUDE 8000.0
+
+// RMS difference (counts) between stream 0 and stream 1 of a tone at hz,
+// sampled skewNs[i] after each sample instant and passed through fd[i]
+double getResidual(FRAC_DELAY fd[2], const uint32_t skewNs[2], double hz)
+{
+    double t, sum = 0;
+    int16_t y[2];
+    uint16_t n;
+    uint8_t i;
+    for (n = 0; n < SAMPLES; n++)
+    {
+        for (i = 0; i < 2; i++)
+        {
+            t = (double)n / RATE + skewNs[i] * 1e-9;
+            y[i] = filterFracDelay(&fd[i], lround(AMPLITUDE * sin(2 * M_PI * hz * t)));
+        }
+        if (n >= WARMUP)
+            sum += (double)(y[1] - y[0]) * (y[1] - y[0]);
+    }
+    return sqrt(sum / (SAMPLES - WARMUP));
+}
+
+void testMu()
+{
+    CHECK(getFracDelayMu(0, RATE) == 0);
+    CHECK(getFracDelayMu(1000, RATE) == 655);
+    CHECK(getFracDelayMu(25000, RATE) == 16384);
+    CHECK(getFracDelayMu(50000, RATE) == 32767);
+    CHECK(getFracDelayMu(1000000, RATE) == 32767);
+}
+
+// Whole-sample delays pass samples through unchanged, and the taps keep
+// unity gain at DC for any fraction
+void testTaps()
+{
+    FRAC_DELAY fd;
+    uint32_t mu;
+    int32_t sum;
+    uint16_t n;
+    bool exact = true, unity = true;
+
+    initFracDelay(&fd, 0);
+    for (n = 0; n < 100; n++)
+        exact &= filterFracDelay(&fd, n * 300 - 15000) == (n == 0 ? 0 : (n - 1) * 300 - 15000);
+    CHECK(exact);
+
+    for (mu = 0; mu < 32768; mu += 7)
+    {
+        initFracDelay(&fd, mu);
+        sum = fd.coeff[0] + fd.coeff[1] + fd.coeff[2] + fd.coeff[3];
+        unity &= sum >= 32766 && sum <= 32770;
+    }
+    CHECK(unity);
+}
+
+// Aligning streams whose sampling instants differ by the SS1 step removes
+// most of the difference between them (over 95% up to 2 kHz); delaying the
+// earlier stream instead (the wrong way round) makes it worse than nothing
+void testAlignment()
+{
+    static const uint32_t steps[4] = {1000, 2000, 4000, 8000};
+    static const double tones[4] = {500, 1000, 2000, 4000};
+    FRAC_DELAY fd[2];
+    uint32_t skew[2], wrong[2];
+    double before, after, reversed;
+    uint8_t s, f;
+
+    printf("step ns  tone Hz  residual (counts RMS): none  aligned  reversed\n");
+    for (s = 0; s < 4; s++)
+        for (f = 0; f < 4; f++)
+        {
+            skew[0] = 0;
+            skew[1] = steps[s];
+            initFracDelay(&fd[0], 0);
+            initFracDelay(&fd[1], 0);
+            before = getResidual(fd, skew, tones[f]);
+
+            alignFracDelays(fd, skew, 2, RATE);
+            CHECK(fd[0].coeff[1] == 32768);
+            after = getResidual(fd, skew, tones[f]);
+
+            wrong[0] = steps[s];
+            wrong[1] = 0;
+            alignFracDelays(fd, wrong, 2, RATE);
+            reversed = getResidual(fd, skew, tones[f]);
+
+            printf("%7u  %7.0f  %27.1f  %7.1f  %8.1f\n", steps[s], tones[f], before, after,
+                   reversed);
+            //cubic interpolation loses accuracy towards the 4 kHz band edge
+            CHECK(after < before / (tones[f] < 4000 ? 20 : 5));
+            CHECK(reversed > before);
+        }
+}
+
+// Host time per filtered sample
+void benchmarkFracDelay()
+{
+    FRAC_DELAY fd;
+    volatile int16_t y;
+    uint64_t start;
+    uint32_t n;
+
+    initFracDelay(&fd, getFracDelayMu(1000, RATE));
+    start = getTestNs();
+    for (n = 0; n < 10000000; n++)
+        y = filterFracDelay(&fd, n);
+    (void)y;
+    printf("filterFracDelay: %.2f ns/sample on the host\n", (getTestNs() - start) / 1e7);
+}
+
+int main(void)
+{
+    testMu();
+    testTaps();
+    testAlignment();
+    benchmarkFracDelay();
+    return finishTest("fracdelay");
+}
@@ -0,0 +1,248 @@
+// Noise floor tracker tests on synthetic room noise: floor accuracy,
+// tracking, false triggers against a fixed trigger, and a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "noisefloor.h"
+
+#define RATE 20000
+#define ENV_SHIFT 6
+#define FALL_SHIFT 9
+#define RISE_SHIFT 14
+#define START_FLOOR 160
+#define MIN_TRIGGER 64
+#define FIXED_TRIGGER 1600                           // 200 raw counts in Q3
+#define HOLDOFF (RATE / 10)
+
+// Room noise with standard deviation sigma: near-Gaussian (sum of four
+// uniforms) through a one-pole low-pass, plus mains hum at a tenth of it
+double noiseState = 0;
+uint32_t noiseTime = 0;
+
+int16_t getRoomNoise(double sigma)
+{
+    double g = 0, x;
+    uint8_t k;
+    for (k = 0; k < 4; k++)
+        g += getTestNoise(10000) / 10000.0;
+    //unit variance after scaling (4 uniforms of variance 1/3) and the
+    //one-pole gain (1 - a^2) with a = 0.6
+    noiseState = 0.6 * noiseState + g * sqrt(3.0 / 4) * 0.8;
+    x = sigma * (noiseState + 0.1 * sqrt(2) * sin(2 * M_PI * 60 * noiseTime++ / RATE)) / sqrt(1.01);
+    return x > 32767 ? 32767 : (x < -32768 ? -32768 : lround(x));
+}
+
+void startNoiseFloor(NOISE_FLOOR *nf)
+{
+    initNoiseFloor(nf, ENV_SHIFT, FALL_SHIFT, RISE_SHIFT, START_FLOOR);
+}
+
+// From the starting floor, the floor settles on mean |x| of the background
+// at every level, and stays there when loud short events come every half
+// second
+void testFloor()
+{
+    static const double sigmas[5] = {4, 40, 400, 2000, 8000};
+    NOISE_FLOOR nf, nfEvents;
+    double mean, sum, error;
+    int16_t x;
+    uint32_t n;
+    uint8_t s;
+
+    printf("noise sigma  mean |x|  floor  floor with events\n");
+    for (s = 0; s < 5; s++)
+    {
+        startNoiseFloor(&nf);
+        startNoiseFloor(&nfEvents);
+        sum = 0;
+        for (n = 0; n < 8 * RATE; n++)
+        {
+            x = getRoomNoise(sigmas[s]);
+            updateNoiseFloor(&nf, x);
+            if (n >= 4 * RATE)
+                sum += x < 0 ? -x : x;
+            //5 ms bursts 20 dB over the noise
+            if (n % (RATE / 2) < RATE / 200)
+                x = fmax(-32768, fmin(32767, x * 10.0));
+            updateNoiseFloor(&nfEvents, x);
+        }
+        mean = sum / (4 * RATE);
+        printf("%11.0f  %8.1f  %5u  %17u\n", sigmas[s], mean, getNoiseFloor(&nf),
+               getNoiseFloor(&nfEvents));
+        //the minimum tracker sits a little under the mean, and reads in
+        //whole counts
+        error = getNoiseFloor(&nf) - mean;
+        CHECK(error > -0.25 * mean - 1 && error < 0.1 * mean);
+        error = getNoiseFloor(&nfEvents) - mean;
+        CHECK(error > -0.25 * mean - 1 && error < 0.25 * mean);
+    }
+}
+
+// A step up in the background is followed over about 2^RISE_SHIFT samples,
+// a step down within a few 2^FALL_SHIFT
+void testTracking()
+{
+    NOISE_FLOOR nf;
+    uint32_t n, up = 0, down = 0;
+    uint16_t low, high;
+
+    startNoiseFloor(&nf);
+    for (n = 0; n < 8 * RATE; n++)
+        updateNoiseFloor(&nf, getRoomNoise(100));
+    low = getNoiseFloor(&nf);
+    for (n = 0; n < 8 * RATE; n++)
+    {
+        updateNoiseFloor(&nf, getRoomNoise(1000));
+        if (up == 0 && getNoiseFloor(&nf) >= (low + 10 * low) / 2)
+            up = n;
+    }
+    high = getNoiseFloor(&nf);
+    for (n = 0; n < 8 * RATE; n++)
+    {
+        updateNoiseFloor(&nf, getRoomNoise(100));
+        if (down == 0 && getNoiseFloor(&nf) <= (low + high) / 2)
+            down = n;
+    }
+    printf("half-way after a 20 dB step: %u samples up, %u down\n", up, down);
+    CHECK(high > 9 * low && high < 11 * low);
+    CHECK(up > (1 << RISE_SHIFT) / 4 && up < 2 << RISE_SHIFT);
+    CHECK(down > 0 && down < 4 << FALL_SHIFT);
+}
+
+// Triggers per minute of background, after the floor has settled; like an
+// event capture, each trigger holds the detector off for HOLDOFF samples,
+// so a trigger that fires constantly counts 600
+uint32_t countTriggers(double sigma, uint8_t marginDb, bool fixed)
+{
+    NOISE_FLOOR nf;
+    uint32_t n, armed = 5 * RATE, count = 0;
+    uint16_t trigger;
+    int16_t x;
+
+    startNoiseFloor(&nf);
+    for (n = 0; n < 65 * RATE; n++)
+    {
+        x = getRoomNoise(sigma);
+        updateNoiseFloor(&nf, x);
+        trigger = fixed ? FIXED_TRIGGER : getNoiseThreshold(&nf, marginDb, MIN_TRIGGER);
+        if (n >= armed && (x > trigger || x < -trigger))
+        {
+            count++;
+            armed = n + HOLDOFF;
+        }
+    }
+    return count;
+}
+
+// On background alone the adaptive trigger stays quiet at every level for
+// a margin of 20 dB, where the fixed 200-count trigger fires constantly in
+// a loud room; narrower margins sit inside the noise and fire almost as
+// often as the holdoff allows
+void testFalseTriggers()
+{
+    static const double sigmas[4] = {20, 200, 1000, 4000};
+    uint32_t adaptive[3], fixed;
+    uint8_t s;
+
+    printf("false triggers per minute\nnoise sigma  fixed  6 dB  12 dB  20 dB\n");
+    for (s = 0; s < 4; s++)
+    {
+        fixed = countTriggers(sigmas[s], 0, true);
+        adaptive[0] = countTriggers(sigmas[s], 6, false);
+        adaptive[1] = countTriggers(sigmas[s], 12, false);
+        adaptive[2] = countTriggers(sigmas[s], 20, false);
+        printf("%11.0f  %5u  %4u  %5u  %5u\n", sigmas[s], fixed, adaptive[0], adaptive[1],
+               adaptive[2]);
+        CHECK(adaptive[2] == 0);
+        if (sigmas[s] >= 1000)
+            CHECK(fixed > 500);
+    }
+}
+
+// Events 26 dB over a quiet background trigger the adaptive level, which
+// the fixed trigger misses
+void testDetection()
+{
+    NOISE_FLOOR nf;
+    uint32_t n, hits = 0, fixedHits = 0;
+    uint16_t trigger;
+    int16_t x;
+    bool hit = false, fixedHit = false;
+
+    startNoiseFloor(&nf);
+    for (n = 0; n < 20 * RATE; n++)
+    {
+        x = getRoomNoise(20);
+        if (n >= 5 * RATE && n % RATE < RATE / 100)
+            x = lround(400 * sin(2 * M_PI * 1000 * n / RATE));
+        updateNoiseFloor(&nf, x);
+        trigger = getNoiseThreshold(&nf, 20, MIN_TRIGGER);
+        hit |= x > trigger || x < -trigger;
+        fixedHit |= x > FIXED_TRIGGER || x < -FIXED_TRIGGER;
+        if (n % RATE == RATE - 1 && n >= 5 * RATE)
+        {
+            hits += hit;
+            fixedHits += fixedHit;
+        }
+        if (n % RATE == RATE - 1)
+            hit = fixedHit = false;
+    }
+    printf("quiet events detected: adaptive %u/15, fixed %u/15\n", hits, fixedHits);
+    CHECK(hits == 15);
+    CHECK(fixedHits == 0);
+}
+
+// The margin table follows 10^(dB/20), and the threshold is clamped to the
+// minimum, 16 bits and the largest margin
+void testThreshold()
+{
+    NOISE_FLOOR nf;
+    double worst = 0, e;
+    uint8_t db;
+
+    initNoiseFloor(&nf, ENV_SHIFT, FALL_SHIFT, RISE_SHIFT, 1000);
+    for (db = 0; db <= NOISE_MAX_MARGIN_DB; db++)
+    {
+        e = fabs(getNoiseThreshold(&nf, db, 0) / (1000 * pow(10, db / 20.0)) - 1);
+        if (pow(10, db / 20.0) * 1000 < 32767 && e > worst)
+            worst = e;
+    }
+    CHECK(worst < 0.005);
+    CHECK(getNoiseThreshold(&nf, 0, 5000) == 5000);
+    CHECK(getNoiseThreshold(&nf, 40, 0) == 32767);
+    initNoiseFloor(&nf, ENV_SHIFT, FALL_SHIFT, RISE_SHIFT, 10);
+    CHECK(getNoiseThreshold(&nf, 255, 0) == getNoiseThreshold(&nf, NOISE_MAX_MARGIN_DB, 0));
+    CHECK(getNoiseFloor(&nf) == 10);
+}
+
+// Host time per sample
+void benchmarkNoiseFloor()
+{
+    static int16_t noise[4096];
+    NOISE_FLOOR nf;
+    uint64_t start;
+    uint32_t n;
+
+    for (n = 0; n < 4096; n++)
+        noise[n] = getRoomNoise(500);
+    startNoiseFloor(&nf);
+    start = getTestNs();
+    for (n = 0; n < 10000000; n++)
+        updateNoiseFloor(&nf, noise[n & 4095]);
+    printf("updateNoiseFloor: %.2f ns/sample on the host (floor %u)\n",
+           (getTestNs() - start) / 1e7, getNoiseFloor(&nf));
+}
+
+int main(void)
+{
+    testFloor();
+    testTracking();
+    testFalseTriggers();
+    testDetection();
+    testThreshold();
+    benchmarkNoiseFloor();
+    return finishTest("noisefloor");
+}
@@ -0,0 +1,213 @@
+// Onset detector tests on synthetic clap recordings and on the state
+// machine's individual rules
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "onset.h"
+
+#define CLAPS 6
+#define SPACING 4000
+#define LENGTH (CLAPS * SPACING + SPACING)
+#define LEVEL 800
+#define HOLDOFF 1000
+
+int16_t recording[ONSET_MICS][LENGTH];
+uint32_t clapTime[CLAPS];
+int16_t clapDelay[CLAPS][ONSET_MICS];
+
+// Claps every SPACING samples, each reaching the mics a few samples apart:
+// a full-scale first sample of random sign, then a ringing noise tail
+// decaying below the level in a few hundred samples, over a quiet floor
+// (Q3 counts)
+void makeRecording()
+{
+    double tail;
+    uint32_t n, t;
+    uint8_t c, m;
+    int16_t sign;
+
+    for (m = 0; m < ONSET_MICS; m++)
+        for (n = 0; n < LENGTH; n++)
+            recording[m][n] = getTestNoise(60);
+    for (c = 0; c < CLAPS; c++)
+    {
+        clapTime[c] = SPACING / 2 + c * SPACING;
+        sign = getTestRandom() & 1 ? 1 : -1;
+        for (m = 0; m < ONSET_MICS; m++)
+        {
+            clapDelay[c][m] = getTestRandom() % 7;
+            for (t = 0; t < 1500; t++)
+            {
+                n = clapTime[c] + clapDelay[c][m] + t;
+                tail = t == 0 ? sign * 12000 : getTestNoise(12000) * exp(-(double)t / 80);
+                recording[m][n] += lround(tail);
+            }
+        }
+    }
+}
+
+// Feed every mic's detector every sample, as main() does, and collect the
+// complete groups; returns the number of groups
+uint8_t runRecording(uint32_t times[][ONSET_MICS], uint8_t max, uint16_t onsets[ONSET_MICS])
+{
+    ONSET_DETECTOR od[ONSET_MICS];
+    ONSET_GROUP group;
+    bool onset[ONSET_MICS];
+    uint32_t n;
+    uint8_t m, groups = 0;
+
+    for (m = 0; m < ONSET_MICS; m++)
+    {
+        initOnsetDetector(&od[m], LEVEL, 100, HOLDOFF, 0, 11);
+        onsets[m] = 0;
+    }
+    initOnsetGroup(&group, 10);
+    for (n = 0; n < LENGTH; n++)
+    {
+        for (m = 0; m < ONSET_MICS; m++)
+        {
+            onset[m] = detectOnset(&od[m], recording[m][n], n);
+            onsets[m] += onset[m];
+        }
+        for (m = 0; m < ONSET_MICS; m++)
+            if (onset[m] && addOnset(&group, m, n) && groups < max)
+            {
+                times[groups][0] = group.time[0];
+                times[groups][1] = group.time[1];
+                times[groups][2] = group.time[2];
+                groups++;
+            }
+    }
+    return groups;
+}
+
+// One onset per mic per clap, on the exact first sample of the wavefront
+// (either sign), so every pair lag is exact; the ringing tail never
+// re-triggers, and a second run gives the same timestamps
+void testClaps()
+{
+    uint32_t times[CLAPS + 2][ONSET_MICS], again[CLAPS + 2][ONSET_MICS];
+    uint16_t onsets[ONSET_MICS];
+    uint8_t groups, c, m;
+    bool exact = true, same = true;
+
+    makeRecording();
+    groups = runRecording(times, CLAPS + 2, onsets);
+    CHECK(groups == CLAPS);
+    CHECK(onsets[0] == CLAPS && onsets[1] == CLAPS && onsets[2] == CLAPS);
+    for (c = 0; c < groups && c < CLAPS; c++)
+        for (m = 0; m < ONSET_MICS; m++)
+            exact &= times[c][m] == clapTime[c] + clapDelay[c][m];
+    CHECK(exact);
+
+    runRecording(again, CLAPS + 2, onsets);
+    for (c = 0; c < groups; c++)
+        for (m = 0; m < ONSET_MICS; m++)
+            same &= times[c][m] == again[c][m];
+    CHECK(same);
+}
+
+// Without a holdoff the ringing tail re-triggers on every swing back above
+// the threshold after dipping below it by the hysteresis
+void testNoHoldoff()
+{
+    ONSET_DETECTOR od;
+    uint32_t n;
+    uint16_t count = 0;
+
+    initOnsetDetector(&od, LEVEL, 100, 0, 0, 11);
+    for (n = 0; n < SPACING; n++)
+        count += detectOnset(&od, recording[0][n], n);
+    CHECK(count > 1);
+}
+
+// Re-arming needs the magnitude below the threshold by the hysteresis
+void testHysteresis()
+{
+    ONSET_DETECTOR od;
+
+    initOnsetDetector(&od, 1000, 200, 0, 0, 11);
+    CHECK(!detectOnset(&od, 1000, 0));
+    CHECK(detectOnset(&od, -1001, 1) && od.time == 1);
+    CHECK(!detectOnset(&od, 801, 2));
+    CHECK(!detectOnset(&od, 1500, 3));
+    CHECK(!detectOnset(&od, 799, 4));
+    CHECK(detectOnset(&od, 1001, 5) && od.time == 5);
+}
+
+// No onset during the holdoff, and a signal still loud when it ends must
+// drop below the threshold first
+void testHoldoff()
+{
+    ONSET_DETECTOR od;
+    uint32_t n;
+    bool quiet = true;
+
+    initOnsetDetector(&od, 1000, 0, 10, 0, 11);
+    CHECK(detectOnset(&od, 2000, 0));
+    CHECK(!detectOnset(&od, 0, 1));
+    for (n = 2; n <= 10; n++)
+        quiet &= !detectOnset(&od, 2000, n);
+    CHECK(quiet);
+    CHECK(!detectOnset(&od, 2000, 11));
+    CHECK(!detectOnset(&od, 0, 12));
+    CHECK(detectOnset(&od, 2000, 13));
+}
+
+// Each onset raises the threshold by the backoff, decaying by 1/2^shift
+// per sample, so a weaker second clap right after is ignored but the same
+// clap later is taken
+void testBackoff()
+{
+    ONSET_DETECTOR od;
+    uint32_t n;
+
+    initOnsetDetector(&od, 1000, 0, 0, 2000, 4);
+    CHECK(detectOnset(&od, 5000, 0));
+    CHECK(!detectOnset(&od, 0, 1));
+    CHECK(!detectOnset(&od, 2500, 2));
+    CHECK(!detectOnset(&od, 0, 3));
+    for (n = 4; n < 200; n++)
+        detectOnset(&od, 0, n);
+    CHECK(od.raise == 0);
+    CHECK(detectOnset(&od, 2500, 200));
+
+    //a level change keeps the raise and the armed state
+    setOnsetLevel(&od, 3000);
+    CHECK(!detectOnset(&od, 0, 201));
+    CHECK(!detectOnset(&od, 2500, 202));
+}
+
+// Groups: lags are signed, a repeat from one mic is ignored, and an onset
+// more than the window after the first starts a new group
+void testGroup()
+{
+    ONSET_GROUP group;
+
+    initOnsetGroup(&group, 6);
+    CHECK(!addOnset(&group, 1, 100));
+    CHECK(!addOnset(&group, 1, 102));
+    CHECK(!addOnset(&group, 0, 103));
+    CHECK(addOnset(&group, 2, 105));
+    CHECK(getOnsetLag(&group, 0, 1) == -3 && getOnsetLag(&group, 0, 2) == 2
+          && getOnsetLag(&group, 1, 2) == 5);
+
+    CHECK(!addOnset(&group, 0, 200));
+    CHECK(!addOnset(&group, 1, 203));
+    CHECK(!addOnset(&group, 2, 207));
+    CHECK(group.seen == 4 && group.first == 207);
+}
+
+int main(void)
+{
+    testClaps();
+    testNoHoldoff();
+    testHysteresis();
+    testHoldoff();
+    testBackoff();
+    testGroup();
+    return finishTest("onset");
+}
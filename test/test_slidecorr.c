@@ -0,0 +1,177 @@
+// Sliding cross-correlation tests: the running sums against a direct
+// correlation at every sample, lag finding, memory and a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "test.h"
+#include "tdoa.h"
+#include "slidecorr.h"
+
+#define LOG2_RING 11
+#define RING (1 << LOG2_RING)
+#define MASK (RING - 1)
+#define WINDOW 1024
+
+int16_t ringA[RING], ringB[RING];
+int16_t source[64];
+
+// sum a[n] b[n + d] over the length samples of a ending maxLag before the
+// newest sample (index), summed directly
+int64_t getCorrRef(uint32_t index, uint16_t length, int16_t maxLag, int16_t d)
+{
+    int64_t r = 0;
+    uint32_t n;
+    uint16_t k;
+    for (k = 0; k < length; k++)
+    {
+        n = index - maxLag - k;
+        r += (int32_t)ringA[n & MASK] * ringB[(n + d) & MASK];
+    }
+    return r;
+}
+
+// Write sample index of band-limited full-scale noise to ring a, and the
+// same noise delay samples later to ring b; the source runs SLIDE_MAX_LAG
+// samples ahead so b can lead a
+void writeSample(uint32_t index, int16_t delay)
+{
+    uint32_t ahead = index + SLIDE_MAX_LAG;
+    source[ahead & 63] = getTestNoise(32767) / 2 + source[(ahead - 1) & 63] / 2;
+    ringA[index & MASK] = source[index & 63];
+    ringB[index & MASK] = source[(index - delay) & 63];
+}
+
+// Fill the rings up to (not including) index next
+void fillRings(uint32_t next, int16_t delay)
+{
+    uint32_t n;
+    for (n = next - RING; n != next; n++)
+        writeSample(n, delay);
+}
+
+// Started anywhere (including across the 32-bit index wrap) and streamed
+// for several ring lengths, every accumulator equals the direct sum after
+// every sample, for any lag span and window that fit the ring (up to the
+// longest, whose oldest sample sits next to the newest)
+void testStreaming()
+{
+    static const int16_t maxLags[4] = {0, 1, 6, SLIDE_MAX_LAG};
+    static const uint16_t lengths[3] = {1, 100, RING - 2 * SLIDE_MAX_LAG - 1};
+    static const uint32_t starts[2] = {12345, 0xFFFFFFFF - 2 * RING};
+    SLIDE_CORR sc;
+    uint32_t index, n;
+    int16_t d;
+    uint8_t m, l, s;
+    bool ok = true;
+
+    for (s = 0; s < 2; s++)
+        for (m = 0; m < 4; m++)
+            for (l = 0; l < 3; l++)
+            {
+                fillRings(starts[s], 3);
+                CHECK(initSlideCorr(&sc, ringA, ringB, MASK, starts[s], lengths[l], maxLags[m]));
+                for (n = 0; n < 4 * RING; n++)
+                {
+                    index = starts[s] + n;
+                    writeSample(index, 3);
+                    updateSlideCorr(&sc, index);
+                    //checking every sample of the longest window is slow
+                    if (lengths[l] > 100 && n % 97 != 0)
+                        continue;
+                    for (d = -maxLags[m]; d <= maxLags[m]; d++)
+                        ok &= sc.acc[maxLags[m] + d] == getCorrRef(index, lengths[l], maxLags[m], d);
+                }
+            }
+    CHECK(ok);
+}
+
+// The vector held as a capture window completes gives the lag of every
+// delay in range exactly (and to within a few 1/256 sample once refined)
+void testLag()
+{
+    SLIDE_CORR sc;
+    uint32_t n;
+    int32_t lagQ8;
+    int16_t d;
+    bool exact = true, refined = true;
+
+    for (d = -SLIDE_MAX_LAG; d <= SLIDE_MAX_LAG; d++)
+    {
+        fillRings(0, d);
+        initSlideCorr(&sc, ringA, ringB, MASK, 0, WINDOW, SLIDE_MAX_LAG);
+        for (n = 0; n < 3 * WINDOW; n++)
+        {
+            writeSample(n, d);
+            updateSlideCorr(&sc, n);
+        }
+        exact &= getSlideCorrLag(sc.acc, SLIDE_MAX_LAG, &lagQ8) == d;
+        if (d > -SLIDE_MAX_LAG && d < SLIDE_MAX_LAG)
+            refined &= lagQ8 >= (d << 8) - 16 && lagQ8 <= (d << 8) + 16;
+        else
+            refined &= lagQ8 == d << 8;
+    }
+    CHECK(exact);
+    CHECK(refined);
+    CHECK(getSlideCorrLag(sc.acc, SLIDE_MAX_LAG, 0) == SLIDE_MAX_LAG);
+}
+
+// Lag spans past SLIDE_MAX_LAG, empty windows and windows that do not fit
+// the ring with their lag span are refused
+void testLimits()
+{
+    SLIDE_CORR sc;
+    CHECK(!initSlideCorr(&sc, ringA, ringB, MASK, 0, WINDOW, SLIDE_MAX_LAG + 1));
+    CHECK(!initSlideCorr(&sc, ringA, ringB, MASK, 0, WINDOW, -1));
+    CHECK(!initSlideCorr(&sc, ringA, ringB, MASK, 0, 0, 6));
+    CHECK(!initSlideCorr(&sc, ringA, ringB, MASK, 0, RING - 12, 6));
+    CHECK(initSlideCorr(&sc, ringA, ringB, MASK, 0, RING - 13, 6));
+}
+
+// Memory per pair is the accumulators plus the ring bookkeeping, and is
+// independent of the window length
+void testMemory()
+{
+    printf("SLIDE_CORR: %d bytes per pair (%d in accumulators), %d for three pairs\n",
+           (int)sizeof(SLIDE_CORR), (int)sizeof(((SLIDE_CORR *)0)->acc),
+           (int)(3 * sizeof(SLIDE_CORR)));
+    CHECK(sizeof(((SLIDE_CORR *)0)->acc) == 8 * (2 * SLIDE_MAX_LAG + 1));
+    CHECK(sizeof(SLIDE_CORR) <= sizeof(((SLIDE_CORR *)0)->acc) + 32);
+}
+
+// Host time per sample for one pair, against recomputing the correlation
+// over the window for every sample
+void benchmarkSlideCorr()
+{
+    SLIDE_CORR sc;
+    volatile int64_t r;
+    uint64_t start;
+    uint32_t n;
+    int16_t d;
+
+    fillRings(0, 2);
+    initSlideCorr(&sc, ringA, ringB, MASK, 0, WINDOW, 6);
+    start = getTestNs();
+    for (n = 0; n < 1000000; n++)
+        updateSlideCorr(&sc, n);
+    printf("updateSlideCorr: %.1f ns/sample on the host (+/-6 lags, any window)\n",
+           (getTestNs() - start) / 1e6);
+
+    start = getTestNs();
+    for (n = 0; n < 1000; n++)
+        for (d = -6; d <= 6; d++)
+            r = getCorrRef(n, WINDOW, 6, d);
+    (void)r;
+    printf("direct correlation: %.1f ns/sample on the host (%d-sample window)\n",
+           (getTestNs() - start) / 1e3, WINDOW);
+}
+
+int main(void)
+{
+    testStreaming();
+    testLag();
+    testLimits();
+    testMemory();
+    benchmarkSlideCorr();
+    return finishTest("slidecorr");
+}
@@ -0,0 +1,174 @@
+// SPL meter tests: the fixed-point log2 and dB levels against float math,
+// with a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "test.h"
+#include "spl.h"
+
+#define BLOCK 32
+#define LOG2_BLOCKS 5
+#define OFFSET_Q8 (60 * SPL_DB_Q8)
+
+// log2Q16 stays within 0.00021 of libm from 1 to 2^63, and is exact at the
+// powers of two
+void testLog2()
+{
+    double error, worst = 0;
+    uint64_t x;
+    uint32_t n;
+    uint8_t e;
+    bool exact = true;
+
+    for (e = 0; e < 64; e++)
+        exact &= log2Q16((uint64_t)1 << e) == (int32_t)e << 16;
+    for (n = 1; n < 100000; n++)
+    {
+        x = n;
+        error = fabs(log2Q16(x) / 65536.0 - log2(x));
+        worst = error > worst ? error : worst;
+    }
+    for (n = 0; n < 100000; n++)
+    {
+        x = ((uint64_t)getTestRandom() << 32 | getTestRandom()) >> (n % 63);
+        if (x == 0)
+            continue;
+        error = fabs(log2Q16(x) / 65536.0 - log2((double)x));
+        worst = error > worst ? error : worst;
+    }
+    printf("log2Q16: worst error %.6f\n", worst);
+    CHECK(exact);
+    CHECK(log2Q16(0) == 0);
+    CHECK(worst < 0.00021);
+}
+
+// Fill count frames with noise of each channel's amplitude
+void getNoiseBlock(int16_t *frames, uint16_t count, const int16_t amp[SPL_CHANNELS])
+{
+    uint16_t n;
+    uint8_t ch;
+    for (n = 0; n < count; n++)
+        for (ch = 0; ch < SPL_CHANNELS; ch++)
+            frames[n * SPL_CHANNELS + ch] = getTestNoise(amp[ch]);
+}
+
+// Through level changes from an RMS near one unit to full scale, every
+// block's reading stays within 0.1 dB of the same running average in float
+void testReference()
+{
+    static const int16_t levels[6] = {2, 10, 300, 3000, 20000, 32767};
+    int16_t frames[BLOCK * SPL_CHANNELS], amp[SPL_CHANNELS];
+    SPL_METER meter;
+    double ms[SPL_CHANNELS] = {0, 0, 0}, sum, ref, error, worst = 0;
+    uint16_t b, n;
+    uint8_t ch;
+
+    initSplMeter(&meter, LOG2_BLOCKS, OFFSET_Q8);
+    for (b = 0; b < 6 * 512; b++)
+    {
+        for (ch = 0; ch < SPL_CHANNELS; ch++)
+            amp[ch] = levels[(b / 512 + 2 * ch) % 6];
+        getNoiseBlock(frames, BLOCK, amp);
+        updateSplMeter(&meter, frames, BLOCK);
+        for (ch = 0; ch < SPL_CHANNELS; ch++)
+        {
+            sum = 0;
+            for (n = 0; n < BLOCK; n++)
+                sum += (double)frames[n * SPL_CHANNELS + ch] * frames[n * SPL_CHANNELS + ch];
+            ms[ch] += (sum / BLOCK - ms[ch]) / (1 << LOG2_BLOCKS);
+            //from the first full time constant on
+            if (b < 4 << LOG2_BLOCKS)
+                continue;
+            ref = 10 * log10(ms[ch]) + OFFSET_Q8 / 256.0;
+            error = fabs(getSplDbQ8(&meter, ch) / 256.0 - ref);
+            worst = error > worst ? error : worst;
+        }
+    }
+    printf("getSplDbQ8: worst error %.3f dB against float\n", worst);
+    CHECK(worst < 0.1);
+}
+
+// A steady tone (whole periods per block) reads 10 log10(A^2 / 2) plus the
+// offset, and its RMS reads A / sqrt(2) to the count
+void testTone()
+{
+    static const int16_t amp[SPL_CHANNELS] = {100, 3000, 30000};
+    int16_t frames[BLOCK * SPL_CHANNELS];
+    SPL_METER meter;
+    uint32_t b, n;
+    uint8_t ch;
+
+    initSplMeter(&meter, LOG2_BLOCKS, OFFSET_Q8);
+    for (b = 0; b < 1000; b++)
+    {
+        for (n = 0; n < BLOCK; n++)
+            for (ch = 0; ch < SPL_CHANNELS; ch++)
+                frames[n * SPL_CHANNELS + ch] =
+                    lround(amp[ch] * sin(2 * M_PI * (b * BLOCK + n) / 16.0));
+        updateSplMeter(&meter, frames, BLOCK);
+    }
+    for (ch = 0; ch < SPL_CHANNELS; ch++)
+    {
+        CHECK(fabs(getSplDbQ8(&meter, ch) / 256.0
+                   - (20 * log10(amp[ch] / sqrt(2)) + 60)) < 0.1);
+        CHECK(abs((int32_t)getSplRms(&meter, ch) - (int32_t)lround(amp[ch] / sqrt(2))) <= 1);
+    }
+}
+
+// Calibration moves only its own channel, by exactly the offset change
+void testOffset()
+{
+    static const int16_t amp[SPL_CHANNELS] = {500, 500, 500};
+    int16_t frames[BLOCK * SPL_CHANNELS];
+    SPL_METER meter;
+    int32_t before[SPL_CHANNELS];
+    uint8_t ch;
+
+    initSplMeter(&meter, LOG2_BLOCKS, OFFSET_Q8);
+    getNoiseBlock(frames, BLOCK, amp);
+    updateSplMeter(&meter, frames, BLOCK);
+    for (ch = 0; ch < SPL_CHANNELS; ch++)
+        before[ch] = getSplDbQ8(&meter, ch);
+    setSplOffset(&meter, 1, OFFSET_Q8 - 3 * SPL_DB_Q8 / 2);
+    setSplOffset(&meter, SPL_CHANNELS, 0);
+    CHECK(getSplDbQ8(&meter, 0) == before[0]);
+    CHECK(getSplDbQ8(&meter, 1) == before[1] - 3 * SPL_DB_Q8 / 2);
+    CHECK(getSplDbQ8(&meter, 2) == before[2]);
+}
+
+// Host time per block update and per level read
+void benchmarkSpl()
+{
+    static const int16_t amp[SPL_CHANNELS] = {8000, 8000, 8000};
+    int16_t frames[BLOCK * SPL_CHANNELS];
+    SPL_METER meter;
+    volatile int32_t db;
+    uint64_t start;
+    uint32_t n;
+
+    initSplMeter(&meter, LOG2_BLOCKS, OFFSET_Q8);
+    getNoiseBlock(frames, BLOCK, amp);
+    start = getTestNs();
+    for (n = 0; n < 100000; n++)
+        updateSplMeter(&meter, frames, BLOCK);
+    printf("updateSplMeter: %.1f ns per %d-frame block on the host\n",
+           (getTestNs() - start) / 1e5, BLOCK);
+    start = getTestNs();
+    for (n = 0; n < 1000000; n++)
+        db = getSplDbQ8(&meter, n % SPL_CHANNELS);
+    (void)db;
+    printf("getSplDbQ8: %.1f ns on the host\n", (getTestNs() - start) / 1e6);
+}
+
+int main(void)
+{
+    testLog2();
+    testReference();
+    testTone();
+    testOffset();
+    benchmarkSpl();
+    return finishTest("spl");
+}
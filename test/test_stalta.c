@@ -0,0 +1,187 @@
+// STA/LTA detector tests: running sums and triggers against a direct
+// double-precision reference, event timing, limits and a host benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "stalta.h"
+
+#define RING_LEN 2048
+#define MASK (RING_LEN - 1)
+#define RATE 20000
+
+int16_t ring[RING_LEN];
+
+// Direct reference: both window energies summed from scratch in double,
+// the same ratio tests, and the same settling
+typedef struct _REF_STA_LTA
+{
+    uint16_t staLen, ltaLen;
+    double on, off;
+    uint32_t settle;
+    bool active;
+} REF_STA_LTA;
+
+double getWindowEnergy(uint32_t index, uint16_t len)
+{
+    double sum = 0;
+    uint16_t k;
+    for (k = 0; k < len; k++)
+        sum += (double)ring[(index - k) & MASK] * ring[(index - k) & MASK];
+    return sum;
+}
+
+int8_t updateRef(REF_STA_LTA *ref, uint32_t index, double *ratio)
+{
+    double lta = getWindowEnergy(index, ref->ltaLen);
+    if (lta < ref->ltaLen)
+        lta = ref->ltaLen;
+    *ratio = (getWindowEnergy(index, ref->staLen) / ref->staLen) / (lta / ref->ltaLen);
+    if (ref->settle > 0)
+    {
+        ref->settle--;
+        return 0;
+    }
+    if (!ref->active && *ratio > ref->on)
+    {
+        ref->active = true;
+        return 1;
+    }
+    if (ref->active && *ratio < ref->off)
+    {
+        ref->active = false;
+        return -1;
+    }
+    return 0;
+}
+
+// Background noise of amplitude noise with a burst of amplitude burst (a
+// 1 kHz tone) from sample on to off
+int16_t getScene(uint32_t n, int16_t noise, int16_t burst, uint32_t on, uint32_t off)
+{
+    int32_t x = getTestNoise(noise);
+    if (n >= on && n < off)
+        x += lround(burst * sin(2 * M_PI * 1000.0 * n / RATE));
+    return x > 32767 ? 32767 : (x < -32768 ? -32768 : x);
+}
+
+// Run a scene through the detector and the reference sample by sample;
+// the sums match exactly, the ratio to Q8 and every trigger and de-trigger
+// falls on the same sample. Returns the number of triggers
+uint16_t runScene(uint16_t staLen, uint16_t ltaLen, uint16_t onQ8, uint16_t offQ8,
+                  int16_t noise, int16_t burst, uint32_t on, uint32_t off, uint32_t length,
+                  uint32_t *start, uint32_t *end)
+{
+    STA_LTA sl;
+    REF_STA_LTA ref = {staLen, ltaLen, onQ8 / 256.0, offQ8 / 256.0, ltaLen, false};
+    double ratio, worst = 0;
+    uint32_t n;
+    uint16_t triggers = 0;
+    int8_t event, refEvent;
+    bool sums = true, events = true;
+
+    for (n = 0; n < RING_LEN; n++)
+        ring[n] = 0;
+    CHECK(initStaLta(&sl, ring, MASK, 0, staLen, ltaLen, onQ8, offQ8));
+    for (n = 0; n < length; n++)
+    {
+        ring[n & MASK] = getScene(n, noise, burst, on, off);
+        event = updateStaLta(&sl, n);
+        refEvent = updateRef(&ref, n, &ratio);
+        sums &= sl.staSum == (uint64_t)getWindowEnergy(n, staLen)
+                && sl.ltaSum == (uint64_t)getWindowEnergy(n, ltaLen);
+        //the Q8 ratio rounds down; compare where it is not saturated
+        if (ratio < 200 && fabs(getStaLtaRatioQ8(&sl) / 256.0 - ratio) > worst)
+            worst = fabs(getStaLtaRatioQ8(&sl) / 256.0 - ratio);
+        events &= event == refEvent;
+        if (event == 1)
+            triggers++;
+    }
+    CHECK(sums);
+    CHECK(events);
+    CHECK(worst < 1 / 256.0);
+    *start = sl.start;
+    *end = sl.end;
+    return triggers;
+}
+
+// A burst 20 dB over the noise triggers within a short window of its start
+// and de-triggers within a short window of its end, at every absolute level
+void testEvent()
+{
+    static const int16_t levels[4] = {10, 100, 1000, 3000};
+    uint32_t start, end;
+    uint8_t l;
+
+    for (l = 0; l < 4; l++)
+    {
+        CHECK(runScene(32, 1024, 4 * 256, 384, levels[l], 10 * levels[l], 3000, 3400, 5000,
+                       &start, &end) == 1);
+        printf("noise %4d: trigger at %u, de-trigger at %u (burst 3000 to 3400)\n", levels[l],
+               start, end);
+        CHECK(start >= 3000 && start < 3000 + 32);
+        CHECK(end >= 3400 && end < 3400 + 32);
+    }
+}
+
+// Background alone, silence, and the settling window never trigger; a
+// burst during settling is not reported
+void testQuiet()
+{
+    uint32_t start, end;
+    CHECK(runScene(32, 1024, 4 * 256, 384, 1000, 0, 0, 0, 20000, &start, &end) == 0);
+    CHECK(runScene(32, 1024, 4 * 256, 384, 0, 0, 0, 0, 5000, &start, &end) == 0);
+    CHECK(runScene(32, 1024, 4 * 256, 384, 10, 3000, 500, 700, 1000, &start, &end) == 0);
+}
+
+// The largest windows and ratio the limit allows stay exact on full-scale
+// input, and settings past the limit are refused
+void testLimits()
+{
+    STA_LTA sl;
+    uint32_t start, end;
+
+    runScene(120, 1024, 65535, 65000, 32767, 0, 0, 0, 3000, &start, &end);
+    runScene(1023, 1024, 2048, 1024, 16000, 32767, 2000, 2600, 4000, &start, &end);
+    CHECK(!initStaLta(&sl, ring, MASK, 0, 130, 1024, 65535, 300));
+    CHECK(!initStaLta(&sl, ring, MASK, 0, 0, 1024, 1024, 384));
+    CHECK(!initStaLta(&sl, ring, MASK, 0, 32, 32, 1024, 384));
+    CHECK(!initStaLta(&sl, ring, MASK, 0, 32, 1025, 1024, 384));
+    CHECK(!initStaLta(&sl, ring, MASK, 0, 32, 1024, 384, 384));
+    CHECK(initStaLta(&sl, ring, MASK, 0, 32, 1024, 1024, 384));
+}
+
+// Host time per update; the same for short and long windows
+void benchmarkStaLta()
+{
+    static const uint16_t lengths[2] = {64, 1024};
+    STA_LTA sl;
+    volatile int8_t event;
+    uint64_t start;
+    uint32_t n;
+    uint8_t l;
+
+    for (n = 0; n < RING_LEN; n++)
+        ring[n] = getTestNoise(2000);
+    for (l = 0; l < 2; l++)
+    {
+        initStaLta(&sl, ring, MASK, 0, 16, lengths[l], 4 * 256, 384);
+        start = getTestNs();
+        for (n = 0; n < 10000000; n++)
+            event = updateStaLta(&sl, n);
+        printf("updateStaLta: %.2f ns/sample on the host (LTA %u samples)\n",
+               (getTestNs() - start) / 1e7, lengths[l]);
+    }
+    (void)event;
+}
+
+int main(void)
+{
+    testEvent();
+    testQuiet();
+    testLimits();
+    benchmarkStaLta();
+    return finishTest("stalta");
+}
@@ -0,0 +1,343 @@
+// Cross-correlation TDOA tests on synthetic delayed signals, with a host
+// benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "test.h"
+#include "tdoa.h"
+
+#define LOG2_RING 11
+#define RING (1 << LOG2_RING)
+#define MASK (RING - 1)
+#define WINDOW 1024
+#define MAX_LAG 6
+
+int16_t source[RING + 64];
+int16_t ringA[RING], ringB[RING];
+
+// Band-limited noise (a short moving average of white noise) around a bias,
+// in the Q3 sample units of the pipeline
+void makeSource(int16_t bias)
+{
+    int32_t sum = 0;
+    int16_t white[RING + 64 + 4] = {0};
+    uint16_t n;
+    for (n = 0; n < RING + 64 + 4; n++)
+        white[n] = getTestNoise(4000);
+    for (n = 0; n < RING + 64; n++)
+    {
+        sum = white[n] + 2 * white[n + 1] + 2 * white[n + 2] + white[n + 3];
+        source[n] = bias + sum / 6;
+    }
+}
+
+// Ring a holds the source, ring b the same source d samples later (b hears
+// it after a for positive d); the capture runs on past the ring end
+void fillRings(int16_t d)
+{
+    uint16_t n;
+    for (n = 0; n < RING; n++)
+    {
+        ringA[n] = source[n + 32];
+        ringB[n] = source[n + 32 - d];
+    }
+}
+
+// Every whole-sample delay in the search range comes back exactly, with no
+// fraction added by the interpolation beyond rounding, also for windows
+// that wrap around the ring end and for biased inputs
+void testExact()
+{
+    static const uint32_t starts[3] = {0, 500, RING - 300};
+    static const int16_t biases[2] = {0, 16000};
+    int32_t lagQ8;
+    int16_t d;
+    uint8_t s, b;
+    bool exact = true, fraction = true;
+
+    for (b = 0; b < 2; b++)
+    {
+        makeSource(biases[b]);
+        for (d = -MAX_LAG; d <= MAX_LAG; d++)
+        {
+            fillRings(d);
+            for (s = 0; s < 3; s++)
+            {
+                exact &= findTdoaLag(ringA, ringB, starts[s], WINDOW, MASK, MAX_LAG, &lagQ8) == d;
+                fraction &= lagQ8 >= (d << 8) - 32 && lagQ8 <= (d << 8) + 32;
+            }
+        }
+    }
+    CHECK(exact);
+    CHECK(fraction);
+}
+
+// The pairs' lags add up: a delay 1-2 and 2-3 give 1-3 as their sum
+void testPairs()
+{
+    static int16_t ring3[RING];
+    int16_t l12, l13, l23;
+    uint16_t n;
+
+    makeSource(0);
+    fillRings(2);
+    for (n = 0; n < RING; n++)
+        ring3[n] = source[n + 32 + 3];
+    l12 = findTdoaLag(ringA, ringB, 100, WINDOW, MASK, MAX_LAG, 0);
+    l13 = findTdoaLag(ringA, ring3, 100, WINDOW, MASK, MAX_LAG, 0);
+    l23 = findTdoaLag(ringB, ring3, 100, WINDOW, MASK, MAX_LAG, 0);
+    CHECK(l12 == 2 && l13 == -3 && l23 == -5);
+}
+
+// Delays past the physical range are not searched (the result sits on the
+// edge), and a narrowed search only looks around its center
+void testRange()
+{
+    int32_t lagQ8;
+    int16_t lag;
+
+    makeSource(0);
+    fillRings(MAX_LAG + 2);
+    CHECK(findTdoaLag(ringA, ringB, 0, WINDOW, MASK, MAX_LAG, &lagQ8) == MAX_LAG);
+    CHECK(lagQ8 == MAX_LAG << 8);
+    fillRings(-3);
+    CHECK(findTdoaLagNear(ringA, ringB, 0, WINDOW, MASK, MAX_LAG, -3, 1, 0) == -3);
+    CHECK(findTdoaLagNear(ringA, ringB, 0, WINDOW, MASK, MAX_LAG, -1, 2, 0) == -3);
+    lag = findTdoaLagNear(ringA, ringB, 0, WINDOW, MASK, MAX_LAG, 3, 2, 0);
+    CHECK(lag >= 1 && lag <= 5);
+    CHECK(findTdoaLag(ringA, ringB, 0, 2 * MAX_LAG, MASK, MAX_LAG, &lagQ8) == 0 && lagQ8 == 0);
+}
+
+// Mean-removed correlation of the n range at lag d, summed directly
+int64_t getCorrRef(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length, int16_t d)
+{
+    int32_t sumA = 0, sumB = 0;
+    int64_t r = 0;
+    int16_t meanA, meanB;
+    uint16_t n;
+    for (n = 0; n < length; n++)
+    {
+        sumA += a[(start + n) & MASK];
+        sumB += b[(start + n) & MASK];
+    }
+    meanA = sumA / length;
+    meanB = sumB / length;
+    for (n = MAX_LAG; n < length - MAX_LAG; n++)
+        r += (int64_t)(a[(start + n) & MASK] - meanA) * (b[(start + n + d) & MASK] - meanB);
+    return r;
+}
+
+// The expanded sums pick the same lag and refine it the same way as the
+// direct mean-removed correlation, on random data with random biases,
+// windows and ring positions (each run of the dot product split by the
+// ring end)
+void testExpanded()
+{
+    int64_t r[2 * MAX_LAG + 1];
+    int32_t lagQ8, refQ8;
+    uint32_t start;
+    uint16_t t, n, length;
+    int16_t d, best, biasA, biasB;
+    bool ok = true;
+
+    for (t = 0; t < 300; t++)
+    {
+        biasA = getTestNoise(16000);
+        biasB = getTestNoise(16000);
+        for (n = 0; n < RING; n++)
+        {
+            ringA[n] = biasA + getTestNoise(8000);
+            ringB[n] = biasB + getTestNoise(8000);
+        }
+        start = getTestRandom();
+        length = 2 * MAX_LAG + 1 + getTestRandom() % WINDOW;
+        best = -MAX_LAG;
+        for (d = -MAX_LAG; d <= MAX_LAG; d++)
+        {
+            r[d + MAX_LAG] = getCorrRef(ringA, ringB, start, length, d);
+            if (r[d + MAX_LAG] > r[best + MAX_LAG])
+                best = d;
+        }
+        refQ8 = best << 8;
+        if (best > -MAX_LAG && best < MAX_LAG)
+            refQ8 += interpolateTdoaPeak(r[best + MAX_LAG - 1], r[best + MAX_LAG],
+                                         r[best + MAX_LAG + 1]);
+        ok &= findTdoaLag(ringA, ringB, start, length, MASK, MAX_LAG, &lagQ8) == best;
+        ok &= lagQ8 == refQ8;
+    }
+    CHECK(ok);
+}
+
+// Sign agreements of the sign correlation's n range at lag d, bit by bit
+int32_t getSignRef(const int16_t *a, const int16_t *b, uint32_t start, uint16_t length, int16_t d)
+{
+    int32_t sumA = 0, sumB = 0, agree = 0;
+    int16_t meanA, meanB;
+    uint16_t n, words;
+    if (length > 32 * TDOA_SIGN_MAX_WORDS)
+        length = 32 * TDOA_SIGN_MAX_WORDS;
+    words = (length - 2 * MAX_LAG) / 32;
+    for (n = 0; n < length; n++)
+    {
+        sumA += a[(start + n) & MASK];
+        sumB += b[(start + n) & MASK];
+    }
+    meanA = sumA / length;
+    meanB = sumB / length;
+    for (n = MAX_LAG; n < MAX_LAG + 32 * words; n++)
+        agree += (a[(start + n) & MASK] < meanA) == (b[(start + n + d) & MASK] < meanB);
+    return agree;
+}
+
+// Sign correlation finds every whole-sample delay of clean signals, picks
+// the same lag as the bit-by-bit count on random data (so the word packing
+// and shifts are right), and refuses windows shorter than one word per lag
+void testSign()
+{
+    static const uint32_t starts[3] = {0, 500, RING - 300};
+    int32_t agree, best;
+    uint32_t start;
+    uint16_t t, n, length;
+    int16_t d, lag, bestLag;
+    uint8_t s;
+    bool exact = true, match = true;
+
+    makeSource(16000);
+    for (d = -MAX_LAG; d <= MAX_LAG; d++)
+    {
+        fillRings(d);
+        for (s = 0; s < 3; s++)
+            exact &= findSignTdoaLag(ringA, ringB, starts[s], WINDOW, MASK, MAX_LAG, &lag)
+                     && lag == d;
+    }
+    CHECK(exact);
+
+    for (t = 0; t < 300; t++)
+    {
+        for (n = 0; n < RING; n++)
+        {
+            ringA[n] = getTestNoise(8000);
+            ringB[n] = getTestNoise(8000);
+        }
+        start = getTestRandom();
+        length = 2 * MAX_LAG + 32 + getTestRandom() % (2 * WINDOW);
+        best = -1;
+        bestLag = 0;
+        for (d = -MAX_LAG; d <= MAX_LAG; d++)
+        {
+            agree = getSignRef(ringA, ringB, start, length, d);
+            if (agree > best)
+            {
+                best = agree;
+                bestLag = d;
+            }
+        }
+        match &= findSignTdoaLag(ringA, ringB, start, length, MASK, MAX_LAG, &lag)
+                 && lag == bestLag;
+    }
+    CHECK(match);
+    CHECK(!findSignTdoaLag(ringA, ringB, 0, 2 * MAX_LAG + 31, MASK, MAX_LAG, &lag));
+    CHECK(findSignTdoaLag(ringA, ringB, 0, 2 * MAX_LAG + 32, MASK, MAX_LAG, &lag));
+}
+
+// Share of random delays found exactly by the full MAC search, the sign
+// search, and a MAC search seeded by the sign lag, with independent noise
+// on each mic; sign correlation is exact down to about 5 dB SNR, and below
+// that its seed still lands within the radius, so the seeded search keeps
+// up with the full one
+void testSignAccuracy()
+{
+    static const int8_t snrs[5] = {20, 10, 5, 0, -5};
+    uint16_t mac, sign, seeded, t, n, amp;
+    uint32_t start;
+    int16_t d, lag;
+    uint8_t s;
+
+    printf("SNR dB  found exactly (%%): MAC  sign  sign-seeded MAC\n");
+    for (s = 0; s < 5; s++)
+    {
+        //the source is about 1220 RMS; uniform noise is amp / sqrt(3) RMS
+        amp = 1220 * sqrt(3) / pow(10, snrs[s] / 20.0);
+        mac = sign = seeded = 0;
+        for (t = 0; t < 200; t++)
+        {
+            makeSource(0);
+            d = (int16_t)(getTestRandom() % (2 * MAX_LAG + 1)) - MAX_LAG;
+            fillRings(d);
+            for (n = 0; n < RING; n++)
+            {
+                ringA[n] += getTestNoise(amp);
+                ringB[n] += getTestNoise(amp);
+            }
+            start = getTestRandom();
+            mac += findTdoaLag(ringA, ringB, start, WINDOW, MASK, MAX_LAG, 0) == d;
+            findSignTdoaLag(ringA, ringB, start, WINDOW, MASK, MAX_LAG, &lag);
+            sign += lag == d;
+            seeded += findTdoaLagNear(ringA, ringB, start, WINDOW, MASK, MAX_LAG, lag, 2, 0) == d;
+        }
+        printf("%6d  %21.1f  %4.1f  %15.1f\n", snrs[s], mac / 2.0, sign / 2.0, seeded / 2.0);
+        if (snrs[s] >= 5)
+            CHECK(sign >= 198);
+        CHECK(seeded >= mac - 2);
+    }
+}
+
+// Lag limits from the spacing, and lags in microseconds (rounded)
+void testUnits()
+{
+    CHECK(getMaxTdoaLag(100, 20000) == 6);
+    CHECK(getMaxTdoaLag(343, 20000) == 20);
+    CHECK(getMaxTdoaLag(0, 20000) == 0);
+    CHECK(getTdoaLagUs(256, 20000) == 50);
+    CHECK(getTdoaLagUs(-256, 20000) == -50);
+    CHECK(getTdoaLagUs(128, 20000) == 25);
+    CHECK(getTdoaLagUs(-3 * 256 - 64, 20000) == -163);
+    CHECK(getTdoaLagUs(0, 20000) == 0);
+}
+
+// Host time for the three pairs of one capture window
+void benchmarkTdoa()
+{
+    volatile int16_t lag;
+    int16_t seed;
+    uint64_t start;
+    uint16_t n;
+
+    makeSource(0);
+    fillRings(2);
+    start = getTestNs();
+    for (n = 0; n < 1000; n++)
+        lag = findTdoaLag(ringA, ringB, n, WINDOW, MASK, MAX_LAG, 0);
+    printf("findTdoaLag: %.1f us per pair (%d samples, +/-%d lags) on the host\n",
+           (getTestNs() - start) / 1e6, WINDOW, MAX_LAG);
+
+    start = getTestNs();
+    for (n = 0; n < 1000; n++)
+        findSignTdoaLag(ringA, ringB, n, WINDOW, MASK, MAX_LAG, &seed);
+    printf("findSignTdoaLag: %.1f us per pair on the host\n", (getTestNs() - start) / 1e6);
+
+    start = getTestNs();
+    for (n = 0; n < 1000; n++)
+    {
+        findSignTdoaLag(ringA, ringB, n, WINDOW, MASK, MAX_LAG, &seed);
+        lag = findTdoaLagNear(ringA, ringB, n, WINDOW, MASK, MAX_LAG, seed, 2, 0);
+    }
+    (void)lag;
+    printf("sign-seeded findTdoaLagNear: %.1f us per pair on the host\n",
+           (getTestNs() - start) / 1e6);
+}
+
+int main(void)
+{
+    testExact();
+    testPairs();
+    testRange();
+    testExpanded();
+    testSign();
+    testSignAccuracy();
+    testUnits();
+    benchmarkTdoa();
+    return finishTest("tdoa");
+}
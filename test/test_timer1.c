@@ -0,0 +1,85 @@
+// Timer 1 and ADC trigger setup tests
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "clock.h"
+#include "timer1.h"
+#include "adc0.h"
+#include "adc1.h"
+
+// Every rate up to the 1 Msps converter limit loads the nearest whole
+// clock count and reads back as fcyc / load
+void testTimer1Rates()
+{
+    uint32_t rate, load;
+    uint32_t bad = 0;
+    for (rate = 1; rate <= 1000000; rate++)
+    {
+        setTimer1Rate(rate, SYSTEM_CLOCK_HZ);
+        load = TIMER1_TAILR_R + 1;
+        if ((uint64_t)load * rate + rate / 2 < SYSTEM_CLOCK_HZ
+            || (uint64_t)load * rate > (uint64_t)SYSTEM_CLOCK_HZ + rate / 2
+            || getTimer1Rate(SYSTEM_CLOCK_HZ) != SYSTEM_CLOCK_HZ / load)
+            bad++;
+    }
+    CHECK(bad == 0);
+
+    //the output rate times each oversampling factor divides 40 MHz exactly
+    for (rate = 20000; rate <= 160000; rate *= 2)
+    {
+        setTimer1Rate(rate, SYSTEM_CLOCK_HZ);
+        CHECK(getTimer1Rate(SYSTEM_CLOCK_HZ) == rate);
+    }
+
+    //a rate above the clock still counts one clock per period
+    setTimer1Rate(SYSTEM_CLOCK_HZ * 2u, SYSTEM_CLOCK_HZ);
+    CHECK(TIMER1_TAILR_R == 0);
+}
+
+// initAdc0Ss1Timed leaves Timer 1A running as a 32-bit periodic ADC trigger
+// and SS1 of both converters started by it
+void testTimedTrigger()
+{
+    static const uint8_t ain0[4] = {1, 4, 1, 4};
+    static const uint8_t ain1[1] = {2};
+
+    resetMockRegs();
+    initAdc0Ss1Timed(20000);
+    CHECK(TIMER1_CFG_R == TIMER_CFG_32_BIT_TIMER);
+    CHECK((TIMER1_TAMR_R & TIMER_TAMR_TAMR_M) == TIMER_TAMR_TAMR_PERIOD);
+    CHECK((TIMER1_CTL_R & (TIMER_CTL_TAEN | TIMER_CTL_TAOTE)) == (TIMER_CTL_TAEN | TIMER_CTL_TAOTE));
+    CHECK(TIMER1_TAILR_R == 1999);
+    CHECK(getAdc0Ss1Rate() == 20000);
+    CHECK((ADC0_EMUX_R & ADC_EMUX_EM1_M) == ADC_EMUX_EM1_TIMER);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_END0 | ADC_SSCTL1_IE0));
+    CHECK(ADC0_ACTSS_R & ADC_ACTSS_ASEN1);
+    CHECK(ADC0_PC_R == ADC_PC_SR_1M);
+
+    //the other sequencers' triggers are left alone
+    CHECK((ADC0_EMUX_R & ~ADC_EMUX_EM1_M) == 0);
+
+    CHECK(setAdc0Ss1Sequence(ain0, 4));
+    CHECK(ADC0_SSMUX1_R == 0x4141);
+    CHECK(ADC0_SSCTL1_R == (ADC_SSCTL1_END3 | ADC_SSCTL1_IE3));
+
+    initAdc1Ss1();
+    CHECK((ADC1_EMUX_R & ADC_EMUX_EM1_M) == ADC_EMUX_EM1_PROCESSOR);
+    selectAdc1Ss1TimerTrigger();
+    CHECK((ADC1_EMUX_R & ADC_EMUX_EM1_M) == ADC_EMUX_EM1_TIMER);
+    CHECK(setAdc1Ss1Sequence(ain1, 1));
+    CHECK(ADC1_SSMUX1_R == 2);
+    CHECK(ADC1_SSCTL1_R == (ADC_SSCTL1_END0 | ADC_SSCTL1_IE0));
+    CHECK(ADC1_ACTSS_R & ADC_ACTSS_ASEN1);
+
+    stopTimer1();
+    CHECK(!(TIMER1_CTL_R & TIMER_CTL_TAEN));
+    CHECK(TIMER1_CTL_R & TIMER_CTL_TAOTE);
+}
+
+int main(void)
+{
+    testTimer1Rates();
+    testTimedTrigger();
+    return finishTest("timer1");
+}
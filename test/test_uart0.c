@@ -0,0 +1,105 @@
+// UART0 line input tests against a simulated receive FIFO
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "test.h"
+#include "uart0.h"
+
+// Characters waiting in the receive FIFO
+char rx[256];
+uint16_t rxHead, rxTail;
+uint32_t frAddr, drAddr;
+
+// FR shows RXFE while nothing is waiting
+void updateRxStatus(uint32_t addr)
+{
+    if (rxHead == rxTail)
+        *getMockReg(addr) |= UART_FR_RXFE;
+    else
+        *getMockReg(addr) &= ~UART_FR_RXFE;
+}
+
+// Each access to DR takes the next character
+void popRx(uint32_t addr)
+{
+    if (rxHead != rxTail)
+        *getMockReg(addr) = (uint8_t)rx[rxTail++];
+}
+
+void startRx()
+{
+    resetMockRegs();
+    frAddr = getMockRegAddr(&UART0_FR_R);
+    drAddr = getMockRegAddr(&UART0_DR_R);
+    setMockRegHook(frAddr, updateRxStatus);
+    setMockRegHook(drAddr, popRx);
+    rxHead = rxTail = 0;
+}
+
+void typeRx(const char *s)
+{
+    while (*s)
+        rx[rxHead++] = *s++;
+}
+
+// A line typed in pieces builds up over calls that never wait, and is
+// handed out once on its carriage return
+void testPieces()
+{
+    USER_DATA data;
+
+    startRx();
+    memset(&data, 0, sizeof(data));
+    CHECK(!getsUart0NoWait(&data));
+    typeRx("mi");
+    CHECK(!getsUart0NoWait(&data));
+    CHECK(rxTail == rxHead);
+    typeRx("c 1");
+    CHECK(!getsUart0NoWait(&data));
+    typeRx("\r");
+    CHECK(getsUart0NoWait(&data));
+    CHECK(strcmp(data.buffer, "mic 1") == 0);
+    CHECK(!getsUart0NoWait(&data));
+}
+
+// Backspace and delete edit the line, control characters are dropped, and
+// characters after a carriage return start the next line
+void testEditing()
+{
+    USER_DATA data;
+
+    startRx();
+    memset(&data, 0, sizeof(data));
+    typeRx("abx\b\x7f" "c\n\td\rnext");
+    CHECK(getsUart0NoWait(&data));
+    CHECK(strcmp(data.buffer, "acd") == 0);
+    CHECK(!getsUart0NoWait(&data));
+    typeRx("\r");
+    CHECK(getsUart0NoWait(&data));
+    CHECK(strcmp(data.buffer, "next") == 0);
+}
+
+// A line that fills the buffer ends there, terminated inside it
+void testFull()
+{
+    USER_DATA data;
+    uint8_t i;
+
+    startRx();
+    memset(&data, 'z', sizeof(data));
+    data.charCount = 0;
+    for (i = 0; i < MAX_CHARS + 5; i++)
+        rx[rxHead++] = 'a' + i % 26;
+    CHECK(getsUart0NoWait(&data));
+    CHECK(strlen(data.buffer) == MAX_CHARS);
+    CHECK(rxHead - rxTail == 5);
+}
+
+int main(void)
+{
+    testPieces();
+    testEditing();
+    testFull();
+    return finishTest("uart0");
+}
@@ -0,0 +1,160 @@
+// uDMA ping-pong tests against the simulated controller
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "test.h"
+#include "udma.h"
+#include "dmasim.h"
+
+#define CH UDMA_CH_ADC0_SS1
+#define BLOCK 8
+
+int16_t ping[BLOCK];
+int16_t pong[BLOCK];
+int16_t bigPing[UDMA_MAX_TRANSFER];
+int16_t bigPong[UDMA_MAX_TRANSFER];
+
+void startChannel(int16_t *a, int16_t *b, uint16_t count)
+{
+    resetMockRegs();
+    initDmaSim();
+    initUdma();
+    startUdmaPingPong16(CH, &ADC0_SSFIFO1_R, a, b, count);
+}
+
+// Blocks of items numbered from first; true if block holds first .. first + count - 1
+bool isRun(const int16_t *block, uint16_t count, int16_t first)
+{
+    uint16_t i;
+    for (i = 0; i < count; i++)
+        if (block[i] != (int16_t)(first + i))
+            return false;
+    return true;
+}
+
+// Serviced in time, the halves alternate and each holds the next items
+void testAlternate()
+{
+    int16_t item = 0;
+    uint16_t i, b;
+    bool ok = true;
+
+    startChannel(ping, pong, BLOCK);
+    CHECK(isDmaSimEnabled(CH));
+    CHECK(serviceUdmaPingPong(CH) == -1);
+    for (b = 0; b < 10; b++)
+    {
+        for (i = 0; i < BLOCK; i++)
+            ok &= requestDmaSim(CH, item++);
+        CHECK(serviceUdmaPingPong(CH) == (b & 1));
+        CHECK(isRun(b & 1 ? pong : ping, BLOCK, item - BLOCK));
+        CHECK(serviceUdmaPingPong(CH) == -1);
+    }
+    CHECK(ok);
+    CHECK(getUdmaStallCount(CH) == 0);
+
+    //a half partly filled is not handed out
+    for (i = 0; i < BLOCK - 1; i++)
+        requestDmaSim(CH, item++);
+    CHECK(serviceUdmaPingPong(CH) == -1);
+    requestDmaSim(CH, item++);
+    CHECK(serviceUdmaPingPong(CH) == 0);
+}
+
+// A service one block late still gets both halves, oldest first; two
+// blocks late, the controller has stopped and the stall is counted
+void testLateService()
+{
+    int16_t item = 0;
+    uint16_t i;
+
+    startChannel(ping, pong, BLOCK);
+    for (i = 0; i < BLOCK + BLOCK / 2; i++)
+        requestDmaSim(CH, item++);
+    CHECK(serviceUdmaPingPong(CH) == 0);
+    CHECK(isRun(ping, BLOCK, 0));
+    CHECK(serviceUdmaPingPong(CH) == -1);
+    for (i = 0; i < BLOCK / 2; i++)
+        requestDmaSim(CH, item++);
+    CHECK(serviceUdmaPingPong(CH) == 1);
+    CHECK(isRun(pong, BLOCK, BLOCK));
+
+    //both halves full and the next item finds the channel stopped
+    for (i = 0; i < 2 * BLOCK; i++)
+        CHECK(requestDmaSim(CH, item++));
+    CHECK(!isDmaSimEnabled(CH));
+    CHECK(!requestDmaSim(CH, item++));
+    CHECK(serviceUdmaPingPong(CH) == 0);
+    CHECK(getUdmaStallCount(CH) == 1);
+    CHECK(isDmaSimEnabled(CH));
+    CHECK(isRun(ping, BLOCK, 2 * BLOCK));
+    CHECK(serviceUdmaPingPong(CH) == 1);
+    CHECK(isRun(pong, BLOCK, 3 * BLOCK));
+    CHECK(serviceUdmaPingPong(CH) == -1);
+
+    //the transfer picks up in the ping half again
+    for (i = 0; i < BLOCK; i++)
+        requestDmaSim(CH, item++);
+    CHECK(serviceUdmaPingPong(CH) == 0);
+    CHECK(isRun(ping, BLOCK, 4 * BLOCK + 1));
+}
+
+// With services at random times, the blocks handed out hold every item
+// the controller took, in order; items are only left behind after a stall
+int16_t accepted[3 * BLOCK * 2000];
+
+void testRandomService()
+{
+    const int16_t *block;
+    int16_t item = 0;
+    uint32_t head = 0, tail = 0, lost = 0;
+    uint16_t n, i, blocks = 0;
+    int8_t half;
+    bool ok = true;
+
+    startChannel(ping, pong, BLOCK);
+    for (n = 0; n < 2000; n++)
+    {
+        for (i = getTestRandom() % (3 * BLOCK); i > 0; i--)
+        {
+            if (requestDmaSim(CH, item))
+                accepted[tail++] = item;
+            else
+                lost++;
+            item++;
+        }
+        while ((half = serviceUdmaPingPong(CH)) >= 0)
+        {
+            block = half ? pong : ping;
+            for (i = 0; i < BLOCK; i++)
+                ok &= block[i] == accepted[head++];
+            blocks++;
+        }
+    }
+    CHECK(ok);
+    CHECK(tail - head < 2 * BLOCK);
+    CHECK(lost > 0);
+    CHECK(getUdmaStallCount(CH) > 0);
+    CHECK(blocks > 1000);
+}
+
+// The largest transfer fills its halves end to end
+void testMaxTransfer()
+{
+    uint16_t i;
+    startChannel(bigPing, bigPong, UDMA_MAX_TRANSFER);
+    for (i = 0; i < UDMA_MAX_TRANSFER; i++)
+        requestDmaSim(CH, i);
+    CHECK(serviceUdmaPingPong(CH) == 0);
+    CHECK(isRun(bigPing, UDMA_MAX_TRANSFER, 0));
+    CHECK(serviceUdmaPingPong(CH) == -1);
+}
+
+int main(void)
+{
+    testAlternate();
+    testLateService();
+    testRandomService();
+    testMaxTransfer();
+    return finishTest("udma");
+}
@@ -0,0 +1,81 @@
+// Timer1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Timer 1A (32-bit periodic), used as the ADC trigger source
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "timer1.h"
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize Timer 1A as a 32-bit periodic down counter (left stopped)
+void initTimer1(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R1;
+    _delay_cycles(3);
+
+    // Configure Timer 1
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;                 // turn-off timer before reconfiguring
+    TIMER1_CFG_R = TIMER_CFG_32_BIT_TIMER;           // configure as 32-bit timer (A+B)
+    TIMER1_TAMR_R = TIMER_TAMR_TAMR_PERIOD;          // configure for periodic mode (count down)
+    TIMER1_IMR_R = 0;                                // no timer interrupt, only the ADC trigger is used
+}
+
+// Set the timeout rate as a function of instruction cycle frequency
+// The timer reloads every (fcyc / rateHz) clocks, so the actual rate is
+// fcyc / round(fcyc / rateHz), which getTimer1Rate() reports
+void setTimer1Rate(uint32_t rateHz, uint32_t fcyc)
+{
+    uint32_t load = (fcyc + rateHz / 2) / rateHz;    // round to the nearest whole clock count
+    if (load == 0)
+        load = 1;
+    TIMER1_TAILR_R = load - 1;                       // timer counts load-1 .. 0, so period is load clocks
+}
+
+// Return the actual timeout rate for the current load value
+uint32_t getTimer1Rate(uint32_t fcyc)
+{
+    return fcyc / (TIMER1_TAILR_R + 1);
+}
+
+// Let each timeout start an ADC conversion (EMUX must select the timer)
+void enableTimer1AdcTrigger(void)
+{
+    TIMER1_CTL_R |= TIMER_CTL_TAOTE;
+}
+
+void disableTimer1AdcTrigger(void)
+{
+    TIMER1_CTL_R &= ~TIMER_CTL_TAOTE;
+}
+
+void startTimer1(void)
+{
+    TIMER1_CTL_R |= TIMER_CTL_TAEN;
+}
+
+void stopTimer1(void)
+{
+    TIMER1_CTL_R &= ~TIMER_CTL_TAEN;
+}
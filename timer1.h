@@ -0,0 +1,35 @@
+// Timer1 Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// Timer 1A (32-bit periodic), used as the ADC trigger source
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef TIMER1_H_
+#define TIMER1_H_
+
+#include <stdint.h>
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initTimer1(void);
+void setTimer1Rate(uint32_t rateHz, uint32_t fcyc);
+uint32_t getTimer1Rate(uint32_t fcyc);
+void enableTimer1AdcTrigger(void);
+void disableTimer1AdcTrigger(void);
+void startTimer1(void);
+void stopTimer1(void);
+
+#endif
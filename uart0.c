@@ -91,44 +91,54 @@ char getcUart0(void)
     return UART0_DR_R & 0xFF;                        // get character from fifo
 }
 
+// Blocking function that returns with a complete line in data->buffer
 void getsUart0(USER_DATA *data)
 {
-    uint8_t count = 0;
-    char ch = '\0';
+    while (!getsUart0NoWait(data));
+}
+
+// Non-blocking line input: adds the characters waiting in the rx fifo to the
+// line in data->buffer (charCount must start at 0) and returns true once the
+// line ends with a carriage return or reaches MAX_CHARS; the next call then
+// starts a new line
+bool getsUart0NoWait(USER_DATA *data)
+{
+    char ch;
 
-    while(1)
+    while (kbhitUart0())
     {
         ch = getcUart0();
 
         if((ch == 8) || (ch == 127))
         {
-            if(count > 0)
+            if(data->charCount > 0)
             {
-                count--;
+                data->charCount--;
             }
         }
         else if(ch == 13)
         {
-            data->buffer[count] = 0;
-            return;
+            data->buffer[data->charCount] = '\0';
+            data->charCount = 0;
+            return true;
         }
         else
         {
             if(ch >= 32)
             {
-                data->buffer[count] = ch;
-                count++;
+                data->buffer[data->charCount] = ch;
+                data->charCount++;
             }
 
-            if(count == MAX_CHARS)
+            if(data->charCount == MAX_CHARS)
             {
-                data->buffer[count + 1] = '\0';
-                return;
+                data->buffer[data->charCount] = '\0';
+                data->charCount = 0;
+                return true;
             }
         }
-
     }
-
+    return false;
 }
 
 // Returns the status of the receive buffer
@@ -161,9 +171,10 @@ void parseFields(USER_DATA *data)
             }
 
         }
-        else if(firstval >= 48 && firstval <= 57)
+        else if((firstval >= 48 && firstval <= 57)
+                || (firstval == '-' && previous == 'd' && data->buffer[i + 1] >= 48 && data->buffer[i + 1] <= 57))
         {
-            //numeric
+            //numeric (a leading minus sign is kept with the digits)
             if(previous == 'd')
             {
                 data->fieldPosition[data->fieldCount] = i;
@@ -239,14 +250,20 @@ int32_t MyAtoi(char * str)
 {
     uint8_t i = 0;
     int32_t res = 0;
+    bool negative = false;
 
+    if(str[0] == '-')
+    {
+        negative = true;
+        i++;
+    }
 
-    for (i = 0; str[i] != '\0'; i++)
+    for (; str[i] != '\0'; i++)
     {
         res = res * 10 + str[i] - '0';
     }
 
-    return res;
+    return negative ? -res : res;
 }
 
 bool isCommand(USER_DATA* data, const char strCommand[], uint8_t minArguments)
@@ -29,6 +29,7 @@
 typedef struct _USER_DATA
 {
     char buffer[MAX_CHARS+1];
+    uint8_t charCount;                               // characters of the line being entered
     uint8_t fieldCount;
     uint8_t fieldPosition[MAX_FIELDS];
     char fieldType[MAX_FIELDS];
@@ -44,6 +45,7 @@ void putcUart0(char c);
 void putsUart0(char* str);
 char getcUart0(void);
 void getsUart0(USER_DATA *data);
+bool getsUart0NoWait(USER_DATA *data);
 bool kbhitUart0(void);
 
 bool isCommand(USER_DATA* data, const char strCommand[], uint8_t minArguments);
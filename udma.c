@@ -0,0 +1,134 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller, peripheral-to-memory ping-pong transfers
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "tm4c123gh6pm.h"
+#include "udma.h"
+
+// Control structure layout (4 words per channel, alternate table 512 bytes up)
+#define SRC_END  0
+#define DST_END  1
+#define CTL      2
+#define ALT      128
+
+//-----------------------------------------------------------------------------
+// Global variables
+//-----------------------------------------------------------------------------
+
+// Control table must be aligned to 1024 bytes
+#pragma DATA_ALIGN(dmaTable, 1024)
+volatile uint32_t dmaTable[256];
+
+// Control word used to re-arm each half, half expected to complete next,
+// and number of times both halves filled before the CPU re-armed one
+uint32_t pingPongCtl[32];
+uint8_t pingPongNext[32];
+uint32_t pingPongStalls[32];
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+// Initialize uDMA controller
+void initUdma(void)
+{
+    // Enable clocks
+    SYSCTL_RCGCDMA_R |= SYSCTL_RCGCDMA_R0;
+    _delay_cycles(3);
+
+    // Configure uDMA
+    UDMA_CFG_R = UDMA_CFG_MASTEN;                    // enable controller
+    UDMA_CTLBASE_R = (uint32_t) dmaTable;            // point to control table
+}
+
+// Start a peripheral-to-memory ping-pong transfer of 16-bit items
+// The source is not incremented (FIFO); each half holds count items and
+// the controller switches to the other half as soon as one fills
+void startUdmaPingPong16(uint8_t channel, volatile uint32_t *src, int16_t *ping, int16_t *pong, uint16_t count)
+{
+    uint32_t mask = 1 << channel;
+    uint8_t i = channel * 4;
+
+    UDMA_ENACLR_R = mask;                            // disable channel for programming
+    UDMA_PRIOCLR_R = mask;                           // default priority
+    UDMA_ALTCLR_R = mask;                            // start with primary structure
+    UDMA_USEBURSTCLR_R = mask;                       // respond to single and burst requests
+    UDMA_REQMASKCLR_R = mask;                        // allow peripheral requests
+
+    pingPongCtl[channel] = UDMA_CHCTL_DSTINC_16 | UDMA_CHCTL_DSTSIZE_16
+                         | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_16
+                         | UDMA_CHCTL_ARBSIZE_1
+                         | ((count - 1) << UDMA_CHCTL_XFERSIZE_S)
+                         | UDMA_CHCTL_XFERMODE_PINGPONG;
+    pingPongNext[channel] = 0;
+    pingPongStalls[channel] = 0;
+
+    dmaTable[i + SRC_END] = (uint32_t) src;          // end pointer is the FIFO itself
+    dmaTable[i + DST_END] = (uint32_t) &ping[count - 1];
+    dmaTable[i + CTL] = pingPongCtl[channel];
+    dmaTable[ALT + i + SRC_END] = (uint32_t) src;
+    dmaTable[ALT + i + DST_END] = (uint32_t) &pong[count - 1];
+    dmaTable[ALT + i + CTL] = pingPongCtl[channel];
+
+    UDMA_ENASET_R = mask;                            // enable channel
+}
+
+void stopUdmaChannel(uint8_t channel)
+{
+    UDMA_ENACLR_R = 1 << channel;
+}
+
+// Return the half (0 = ping, 1 = pong) that finished, re-arming it behind the
+// half now being filled, or -1 if the expected half is still in progress
+// Call until it returns -1 so that a late service does not lose a block
+int8_t serviceUdmaPingPong(uint8_t channel)
+{
+    uint32_t mask = 1 << channel;
+    uint8_t half = pingPongNext[channel];
+    uint16_t i = channel * 4 + (half ? ALT : 0);
+
+    if ((dmaTable[i + CTL] & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_STOP)
+        return -1;
+
+    dmaTable[i + CTL] = pingPongCtl[channel];        // re-arm the finished half
+    pingPongNext[channel] = half ^ 1;
+
+    // Both halves completed before this one was re-armed, so the controller
+    // has disabled the channel and data was left in the peripheral
+    if (!(UDMA_ENASET_R & mask))
+    {
+        pingPongStalls[channel]++;
+        UDMA_ENASET_R = mask;
+    }
+    return half;
+}
+
+bool isUdmaChannelInterrupt(uint8_t channel)
+{
+    return (UDMA_CHIS_R & (1 << channel)) != 0;
+}
+
+void clearUdmaChannelInterrupt(uint8_t channel)
+{
+    UDMA_CHIS_R = 1 << channel;                      // write 1 to clear
+}
+
+uint32_t getUdmaStallCount(uint8_t channel)
+{
+    return pingPongStalls[channel];
+}
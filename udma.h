@@ -0,0 +1,42 @@
+// uDMA Library
+
+//-----------------------------------------------------------------------------
+// Hardware Target
+//-----------------------------------------------------------------------------
+
+// Target Platform: EK-TM4C123GXL
+// Target uC:       TM4C123GH6PM
+// System Clock:    -
+
+// Hardware configuration:
+// uDMA controller, peripheral-to-memory ping-pong transfers
+
+//-----------------------------------------------------------------------------
+// Device includes, defines, and assembler directives
+//-----------------------------------------------------------------------------
+
+#ifndef UDMA_H_
+#define UDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Channel numbers (encoding 0)
+#define UDMA_CH_ADC0_SS1 15
+
+// Maximum items in one transfer (XFERSIZE is 10 bits, minus 1)
+#define UDMA_MAX_TRANSFER 1024
+
+//-----------------------------------------------------------------------------
+// Subroutines
+//-----------------------------------------------------------------------------
+
+void initUdma(void);
+void startUdmaPingPong16(uint8_t channel, volatile uint32_t *src, int16_t *ping, int16_t *pong, uint16_t count);
+void stopUdmaChannel(uint8_t channel);
+int8_t serviceUdmaPingPong(uint8_t channel);
+bool isUdmaChannelInterrupt(uint8_t channel);
+void clearUdmaChannelInterrupt(uint8_t channel);
+uint32_t getUdmaStallCount(uint8_t channel);
+
+#endif